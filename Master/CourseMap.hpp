@@ -0,0 +1,172 @@
+//*************************************************************************************
+/** @file    CourseMap.hpp
+ *  @brief   Map of the course and the routes between places on it
+ *  @details Everything the nav task knows about the field is here instead of
+ * 			 spread through its constants and stages: the lines, the walls, the
+ * 			 places it drives between and the routes that join them. It is all
+ * 			 constant tables made from constant expressions, so the compiler
+ * 			 works it out and it lives in flash.
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *	  \li 10-18-2026 ARB Routes are in inches and end on the place they go to
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _COURSEMAP_H_
+#define _COURSEMAP_H_
+
+#include "shares.hpp"
+#include "LandmarkClass.hpp"
+#include "PursuitClass.hpp"
+
+/**************************************************************************************
+ * Course Map
+ **************************************************************************************/
+/** @brief  The field, in mm from where the robot starts: x down the field and y
+ * 			to the left.
+ *  @details The positions are nominal, from the field drawing. Measure them on
+ * 			 the real field and change them here. To add a route, add its
+ * 			 waypoints, ending on the place it goes to, and a line to
+ * 			 @c CourseRoutes. Nav can then drive it with
+ * 			 @c NAV_ROUTE without a new stage.
+ *
+ * 			 The places are the @c PLACE_ defines in shares.hpp, so other tasks
+ * 			 can name them.
+ */
+
+//Field distances are drawn in inches
+#define COURSE_IN(in)       FLOAT2Q16((in) * 25.4)
+
+//A waypoint, Q16 mm, and the top speed on the way to it, in mm/s
+#define COURSE_POINT(x, y, speed) {x, y, speed}
+
+
+//-----------Lines-------------
+//In order down the field. Calibration uses the first two.
+const LandmarkClass::Line CourseLines[] =
+{
+	{LandmarkClass::LINE_X, COURSE_IN(48)},  //Center line
+	{LandmarkClass::LINE_X, COURSE_IN(90)}   //Supply line
+};
+
+#define NUM_COURSE_LINES    (sizeof(CourseLines) / sizeof(CourseLines[0]))
+
+//How far past the center line to drive before picking up the supply line
+#define CENTER_CROSS_DIST   COURSE_IN(3)
+
+
+//-----------Walls-------------
+//A wall the robot drives up to with the sonar
+struct CourseWall
+{
+	Q16 stopDist;  /**<Sonar distance to stop at when driving up to it, mm*/
+	Q16 backDist;  /**<Sonar distance to back up to when leaving it, mm*/
+};
+
+#define WALL_SUPPLY         0
+#define WALL_SCORE          1
+
+const CourseWall CourseWalls[] =
+{
+	{COURSE_IN(3), COURSE_IN(9)},   //Supply wall, rings hang 3 in out from it
+	{COURSE_IN(3), COURSE_IN(9)}    //Score wall, pegs 3 in out from it
+};
+
+
+//-----------Places------------
+//Somewhere a route starts or ends
+struct CoursePlace
+{
+	Q16 x;         /**<mm*/
+	Q16 y;         /**<mm*/
+	U8 wall;       /**<Wall the robot faces there, a WALL_ define*/
+};
+
+//Where the places are. The routes to a place end here too.
+#define SUPPLY_X            (COURSE_IN(90) - COURSE_IN(1))  //AuxLight on the supply line
+#define SUPPLY_Y            0
+#define SCORE_X             COURSE_IN(12)                   //In front of the pegs
+#define SCORE_Y             COURSE_IN(12)
+
+//In the order of the PLACE_ defines
+const CoursePlace CoursePlaces[NUM_PLACES] =
+{
+	{0, 0, WALL_SUPPLY},                                       //PLACE_START
+	{SUPPLY_X, SUPPLY_Y, WALL_SUPPLY},                         //PLACE_SUPPLY
+	{SCORE_X, SCORE_Y, WALL_SCORE}                             //PLACE_SCORE
+};
+
+
+//-----------Routes------------
+//Supply back down the field to the pegs, slowing for the last leg
+const PursuitClass::Point SupplyToScore[] =
+{
+	COURSE_POINT(COURSE_IN(71), COURSE_IN(6), 250),
+	COURSE_POINT(COURSE_IN(48), SCORE_Y, 250),        //Across the center line
+	COURSE_POINT(SCORE_X, SCORE_Y, 120)               //PLACE_SCORE
+};
+
+//Pegs back up the field to the supply line
+const PursuitClass::Point ScoreToSupply[] =
+{
+	COURSE_POINT(COURSE_IN(48), SCORE_Y, 250),
+	COURSE_POINT(COURSE_IN(71), COURSE_IN(6), 250),
+	COURSE_POINT(SUPPLY_X, SUPPLY_Y, 120)             //PLACE_SUPPLY
+};
+
+//A way from one place to another
+struct CourseRoute
+{
+	U8 from;                           /**<A PLACE_ define*/
+	U8 to;                             /**<A PLACE_ define*/
+	const PursuitClass::Point* p_Path; /**<Waypoints after the start*/
+	U8 count;                          /**<Number of waypoints*/
+};
+
+#define ROUTE(from, to, path) {from, to, path, sizeof(path) / sizeof(path[0])}
+
+const CourseRoute CourseRoutes[] =
+{
+	ROUTE(PLACE_SUPPLY, PLACE_SCORE, SupplyToScore),
+	ROUTE(PLACE_SCORE, PLACE_SUPPLY, ScoreToSupply)
+};
+
+
+/** @brief   Find the route between two places
+ *  @param   from Place the robot is at, a PLACE_ define
+ *  @param   to   Place to go to, a PLACE_ define
+ *  @return  The route, or 0 if there isn't one
+ */
+
+inline const CourseRoute* findRoute(U8 from, U8 to)
+{
+	for (U8 n = 0; n < sizeof(CourseRoutes) / sizeof(CourseRoutes[0]); n++)
+	{
+		if (CourseRoutes[n].from == from && CourseRoutes[n].to == to)
+		{
+			return &CourseRoutes[n];
+		}
+	}
+	
+	return 0;
+}
+
+#endif
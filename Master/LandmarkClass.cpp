@@ -0,0 +1,310 @@
+//*************************************************************************************
+/** @file    LandmarkClass.cpp
+ *  @brief   Cpp file for the landmark class
+ *  @details Matches line crossings to the table of lines and corrects the
+ * 			 odometry.
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+//Need header file for the class
+#include "LandmarkClass.hpp"
+
+/**************************************************************************************
+ * Constants
+ **************************************************************************************/
+
+//Half the width of the tape, Q16 mm. The sensor sees the near edge first.
+#define LINE_HALF_WIDTH 624230 //3/8 in = 9.525 mm
+
+//Farthest a crossing can be from a line and still match it, Q16 mm
+#define MATCH_GATE 9830400 //150 mm
+
+//Sensor has to cross a line at more than 30 degrees to it: no more than sqrt(3) times as far along it as across
+#define MAX_ALONG 3
+
+//Sensor has to have moved across the line at least this far between readings, Q16 mm
+#define MIN_MOVE 16384 //0.25 mm
+
+
+/**************************************************************************************
+ * Constructor
+ **************************************************************************************/
+/** @brief  Class constructor
+ *  @details The tables are not copied, so they must last as long as the object.
+ * 	@param   p_Bot      Robot whose pose is corrected
+ * 	@param   p_Lines    Lines on the field
+ * 	@param   numLines   Number of lines
+ * 	@param   p_Sensors  Light sensors on the robot, indexed by the sensor number given to Check()
+ * 	@param   numSensors Number of sensors, at most MAX_SENSORS
+ */
+
+	LandmarkClass::LandmarkClass(RobotClass* p_Bot, const Line* p_Lines, U8 numLines, const Sensor* p_Sensors, U8 numSensors)
+	{
+		this -> p_Bot = p_Bot;
+		this -> p_Lines = p_Lines;
+		NumLines = numLines;
+		this -> p_Sensors = p_Sensors;
+		NumSensors = (numSensors > MAX_SENSORS) ? MAX_SENSORS : numSensors;
+		
+		//Don't trust the first reading, the robot may start on a line
+		for (U8 n = 0; n < MAX_SENSORS; n++)
+		{
+			OnLine[n] = true;
+			LastTick[n] = 0;
+		}
+		
+		LogHead = 0;
+		LogCount = 0;
+		Snaps = 0;
+		Misses = 0;
+	}
+	
+	
+/**************************************************************************************
+ * Check
+ **************************************************************************************/
+/** @brief  Look at one sensor's brightness
+ *  @details Call it each time the sensor is read. Only the step from the floor
+ *			 onto a line does anything.
+ * 	@param   sensor     Index of the sensor in the table
+ * 	@param   brightness What it read
+ * 	@param   tick       When it was read
+ * 	@return  True if the pose was corrected
+ */
+	
+	bool LandmarkClass::Check(U8 sensor, S16 brightness, U32 tick)
+	{
+		bool snapped = false;
+		
+		if (sensor >= NumSensors) {return false;}
+		
+		const Sensor& s = p_Sensors[sensor];
+		
+		if (!OnLine[sensor] && brightness > s.threshold)
+		{
+			OnLine[sensor] = true;
+			
+			//Which way the sensor went is only known with a reading from before
+			if (LastTick[sensor] != 0)
+			{
+				snapped = Snap(sensor, LastTick[sensor], tick);
+			}
+		}
+		else if (OnLine[sensor] && brightness < s.threshold - LINE_HYSTERESIS)
+		{
+			OnLine[sensor] = false;
+		}
+		
+		LastTick[sensor] = tick;
+		
+		return snapped;
+	}
+	
+	
+/**************************************************************************************
+ * Ignore
+ **************************************************************************************/
+/** @brief  Stop looking at a sensor until it has been off a line again
+ *  @details For while a sensor is used for something else, like following
+ *			 the edge of a line. Call it instead of @c Check().
+ * 	@param   sensor Index of the sensor in the table
+ */
+	
+	void LandmarkClass::Ignore(U8 sensor)
+	{
+		if (sensor >= NumSensors) {return;}
+		
+		OnLine[sensor] = true;
+		LastTick[sensor] = 0;
+	}
+	
+	
+/**************************************************************************************
+ * Snap
+ **************************************************************************************/
+/** @brief  Find the line that was crossed and correct the pose
+ *  @details Works out where the sensor was at the crossing, and which way it
+ *			 was going from where it was at the reading before to where it is
+ *			 now. That is the way the sensor itself moved, so it is right when
+ *			 the robot backs up or swings the sensor round on a turn, where the
+ *			 heading would give the wrong edge. The edge the sensor comes to
+ *			 first is found for each line it crossed steeply enough, and the
+ *			 closest one inside @c MATCH_GATE is used.
+ *
+ *			 Nothing is done while the robot turns in place, which is when the
+ *			 wheels go opposite ways. The sensor sweeps round on an arc then, so
+ *			 it may cross the line at a shallow angle or not at all.
+ * 	@param   sensor   Index of the sensor in the table
+ * 	@param   fromTick When the sensor was last seen off the line
+ * 	@param   toTick   When it was first seen on it
+ * 	@return  True if a line matched
+ */
+	
+	bool LandmarkClass::Snap(U8 sensor, U32 fromTick, U32 toTick)
+	{
+		RobotClass::PoseStamp from;
+		RobotClass::PoseStamp pose;
+		RobotClass::PoseStamp to;
+		Q16 wheelRad;
+		Q16 wheelBase;
+		Q16 ds;
+		Q16 turn;
+		Q16 fromPos[2];
+		Q16 sensorPos[2];
+		Q16 toPos[2];
+		Q16 moved[2];
+		Q16 across;
+		Q16 along;
+		Q16 edge;
+		Q16 error;
+		Q16 bestError = 0;
+		U8 best = NumLines;
+		
+		//The line came somewhere between the two readings
+		p_Bot -> poseAt(fromTick, from);
+		p_Bot -> poseAt(fromTick + (toTick - fromTick) / 2, pose);
+		p_Bot -> poseAt(toTick, to);
+		
+		//Each wheel goes ds -+ turn, so they go opposite ways when |ds| < turn
+		p_Bot -> GetGeometry(wheelRad, wheelBase);
+		ds = Q16mul(to.x - from.x, CosQ16(pose.theta)) + Q16mul(to.y - from.y, SinQ16(pose.theta));
+		turn = Q16mul((Q16) (((S64) (S32) (to.theta - from.theta) * Q16_TWO_PI) >> 32), wheelBase / 2);
+		
+		if ((ds < 0 ? -ds : ds) < (turn < 0 ? -turn : turn)) {return false;}
+		
+		SensorAt(sensor, from, fromPos);
+		SensorAt(sensor, pose, sensorPos);
+		SensorAt(sensor, to, toPos);
+		moved[LINE_X] = toPos[LINE_X] - fromPos[LINE_X];
+		moved[LINE_Y] = toPos[LINE_Y] - fromPos[LINE_Y];
+		
+		for (U8 n = 0; n < NumLines; n++)
+		{
+			const Line& line = p_Lines[n];
+			
+			across = moved[line.axis];
+			along = moved[1 - line.axis];
+			if (across < 0) {across = -across;}
+			if (along < 0) {along = -along;}
+			
+			//Running along the line doesn't cross it
+			if (across < MIN_MOVE || (S64) along * along > (S64) MAX_ALONG * across * across) {continue;}
+			
+			//The near edge is the one seen
+			edge = (moved[line.axis] > 0) ? line.pos - LINE_HALF_WIDTH : line.pos + LINE_HALF_WIDTH;
+			error = edge - sensorPos[line.axis];
+			
+			if (error < MATCH_GATE && error > -MATCH_GATE &&
+				(best == NumLines || (error < 0 ? -error : error) < (bestError < 0 ? -bestError : bestError)))
+			{
+				best = n;
+				bestError = error;
+			}
+		}
+		
+		if (best == NumLines)
+		{
+			Misses++;
+			return false;
+		}
+		
+		//Move the robot by the residual, along the line's normal only
+		if (p_Lines[best].axis == LINE_X)
+		{
+			p_Bot -> Correct(bestError, 0);
+		}
+		else
+		{
+			p_Bot -> Correct(0, bestError);
+		}
+		
+		Log[LogHead].tick = pose.tick;
+		Log[LogHead].line = best;
+		Log[LogHead].sensor = sensor;
+		Log[LogHead].error = bestError;
+		
+		LogHead = (LogHead + 1 >= LOG_SIZE) ? 0 : LogHead + 1;
+		if (LogCount < LOG_SIZE) {LogCount++;}
+		
+		Snaps++;
+		
+		return true;
+	}
+	
+	
+/**************************************************************************************
+ * Sensor At
+ **************************************************************************************/
+/** @brief  Where a sensor is on the field for a pose of the robot
+ * 	@param   sensor Index of the sensor in the table
+ * 	@param   pose   Pose of the robot
+ * 	@param   pos    Where the sensor's x and y are written, Q16 mm
+ */
+	
+	void LandmarkClass::SensorAt(U8 sensor, const RobotClass::PoseStamp& pose, Q16 pos[2])
+	{
+		const Sensor& s = p_Sensors[sensor];
+		Q16 cosTheta = CosQ16(pose.theta);
+		Q16 sinTheta = SinQ16(pose.theta);
+		
+		pos[LINE_X] = pose.x + Q16mul(s.forward, cosTheta) - Q16mul(s.left, sinTheta);
+		pos[LINE_Y] = pose.y + Q16mul(s.forward, sinTheta) + Q16mul(s.left, cosTheta);
+	}
+	
+	
+/**************************************************************************************
+ * Get Residual
+ **************************************************************************************/
+/** @brief  Read one of the logged residuals
+ * 	@param   n   Which one, 0 is the newest
+ * 	@param   res Where it is written
+ * 	@return  False if fewer than n + 1 have been logged
+ */
+	
+	bool LandmarkClass::GetResidual(U8 n, Residual& res)
+	{
+		if (n >= LogCount) {return false;}
+		
+		res = Log[(LogHead + LOG_SIZE - 1 - n) % LOG_SIZE];
+		
+		return true;
+	}
+	
+	
+/**************************************************************************************
+ * Counters
+ **************************************************************************************/
+/** @brief  Crossings that corrected the pose
+ */
+	
+	U32 LandmarkClass::GetSnapCount(void)
+	{
+		return Snaps;
+	}
+	
+/** @brief  Crossings that didn't match any line
+ */
+	
+	U32 LandmarkClass::GetMissCount(void)
+	{
+		return Misses;
+	}
@@ -0,0 +1,153 @@
+//*************************************************************************************
+/** @file    LandmarkClass.hpp
+ *  @brief   Corrects the odometry when a light sensor crosses a known line
+ *  @details The lines on the field are at known places. When a light sensor
+ * 			 sees one, the robot's position along the line's normal is known
+ * 			 too, so the odometry drift in that direction can be thrown away.
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *	  \li 10-18-2026 ARB LINE_HYSTERESIS is here for the nav task to use too
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _LANDMARKCLASS_H_
+#define _LANDMARKCLASS_H_
+
+#include "RobotClass.hpp"
+
+/**************************************************************************************
+ * Landmark Class Header
+ **************************************************************************************/
+/** @brief  Snaps the robot's pose to known lines as the light sensors cross them.
+ *  @details Every line on the field runs along x or y, so it pins down one
+ *			 coordinate. Each time through the nav loop the brightness of each
+ *			 sensor is handed to @c Check(). When a sensor goes from the floor
+ *			 onto a line, the crossing is taken to be halfway between the last
+ *			 two readings, and @c RobotClass::poseAt() gives where the sensor
+ *			 was then. The way the sensor moved between the two readings says
+ *			 which edge of the tape it came to, even backing up. The nearest
+ *			 line that could have been crossed that way is looked up, and if it
+ *			 is close enough the robot is moved by the difference (the
+ *			 residual). Crossings while the robot turns in place are skipped.
+ *
+ *			 Residuals are kept in a short log, so a growing one shows the
+ *			 wheel geometry needs calibrating. Crossings that don't match any
+ *			 line are counted but change nothing.
+ */
+
+
+class LandmarkClass
+{
+
+public:
+
+	//Which coordinate a line pins down
+	enum lineAxis
+	{
+		LINE_X = 0,    /**<Line of constant x, runs along y*/
+		LINE_Y = 1     /**<Line of constant y, runs along x*/
+	};
+	
+	//One line on the field
+	struct Line
+	{
+		U8 axis;       /**<A lineAxis*/
+		Q16 pos;       /**<Where the middle of the line is, mm*/
+	};
+	
+	//Where a light sensor is on the robot and what it sees as a line
+	struct Sensor
+	{
+		Q16 forward;   /**<Ahead of the middle of the axle, mm*/
+		Q16 left;      /**<Left of the middle of the axle, mm*/
+		S16 threshold; /**<Brightness above this is a line*/
+	};
+	
+	//One correction
+	struct Residual
+	{
+		U32 tick;      /**<Time of the crossing, ms*/
+		U8 line;       /**<Index of the line in the table*/
+		U8 sensor;     /**<Index of the sensor that saw it*/
+		Q16 error;     /**<Line position less the odometry, mm*/
+	};
+	
+	//Most sensors that can be checked
+	static const U8 MAX_SENSORS = 2;
+	
+	//Number of residuals kept
+	static const U8 LOG_SIZE = 16;
+	
+	//Brightness has to drop this far below the threshold to be off the line again
+	static const S16 LINE_HYSTERESIS = 10;
+	
+	//Constructor
+	LandmarkClass(RobotClass* p_Bot, const Line* p_Lines, U8 numLines, const Sensor* p_Sensors, U8 numSensors);
+	
+	//Look at one sensor's brightness, true if it corrected the pose (same task as RobotClass::Update)
+	bool Check(U8 sensor, S16 brightness, U32 tick);
+	
+	//Stop looking at a sensor until it has been off a line again
+	void Ignore(U8 sensor);
+	
+	//A logged residual, 0 is the newest. False if there aren't that many.
+	bool GetResidual(U8 n, Residual& res);
+	
+	//Crossings that corrected the pose, and ones that matched no line
+	U32 GetSnapCount(void);
+	U32 GetMissCount(void);
+	
+protected:
+
+	//Robot whose pose is corrected
+	RobotClass* p_Bot;
+	
+	//Lines on the field and sensors on the robot
+	const Line* p_Lines;
+	U8 NumLines;
+	const Sensor* p_Sensors;
+	U8 NumSensors;
+	
+	//What each sensor saw last time
+	bool OnLine[MAX_SENSORS];
+	U32 LastTick[MAX_SENSORS];
+	
+	//Recent residuals
+	Residual Log[LOG_SIZE];
+	U8 LogHead;
+	U8 LogCount;
+	
+	U32 Snaps;
+	U32 Misses;
+	
+	//Find the line crossed between two readings and correct the pose
+	bool Snap(U8 sensor, U32 fromTick, U32 toTick);
+	
+	//Where a sensor is for a pose of the robot
+	void SensorAt(U8 sensor, const RobotClass::PoseStamp& pose, Q16 pos[2]);
+
+};
+
+
+//Fixes weird linker issues....
+#include "LandmarkClass.cpp"
+
+#endif
@@ -0,0 +1,815 @@
+//*************************************************************************************
+/** @file    NavCheck.cpp
+ *  @brief   Checks the nav classes on a PC
+ *  @details This is not part of the Master brick's build. It compiles the real
+ * 			 nav classes against the simulated motors in lib/MotorSim.hpp and
+ * 			 drives them through cases where the right answer is known. Each
+ * 			 check prints what it saw, and the program exits with 1 if any of
+ * 			 them failed.
+ *
+ * 			 The robot is simulated the way OdoReplay.cpp does it: the wheels
+ * 			 turn smoothly, the encoders read whole degrees, @c Sample() runs
+ * 			 every ms and @c Update() every 20 ms.
+ *
+ * 			 Build and run with:
+ * 			 @code
+ * 			 g++ -O2 -Wall -Wextra -DHOST_BUILD -I../lib NavCheck.cpp -o NavCheck -lpthread
+ * 			 ./NavCheck
+ * 			 @endcode
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *	  \li 10-18-2026 ARB Checks poseAt() and the history moving with Correct()
+ *	  \li 10-18-2026 ARB Checks the wheel speeds at speed, creeping and stopped
+ *	  \li 10-18-2026 ARB Wall filter check counts rejects and readings to start over
+ *	  \li 10-18-2026 ARB Checks the drive profile's limits and braking distance
+ *	  \li 10-18-2026 ARB Checks the pursuit curvature and follows paths to the end
+ *	  \li 10-18-2026 ARB Pursuit checks include goals beside and behind the robot
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+#ifndef HOST_BUILD
+#error NavCheck.cpp only builds on a PC, with -DHOST_BUILD
+#endif
+
+#include <cstdio>
+#include <cmath>
+
+#include "RobotClass.hpp"
+#include "LandmarkClass.hpp"
+#include "WallFilterClass.hpp"
+#include "ProfileClass.hpp"
+#include "PursuitClass.hpp"
+
+
+/**************************************************************************************
+ * Constants
+ **************************************************************************************/
+
+//ms between calls to Update(), the nav task's period
+#define UPDATE_PERIOD 20
+
+//The robot that is simulated
+#define MM_PER_DEG (RobotClass::WHEEL_RAD / 65536.0 * 2 * M_PI / 360)
+#define BASE_MM    (RobotClass::WHEEL_BASE / 65536.0)
+
+//Where the line is in the landmark checks, and how far off the odometry starts, mm
+#define LINE_MM      500.0
+#define TAPE_HALF_MM 9.525
+#define START_ERR_MM 20.0
+
+//How close a snap has to put the robot to the truth, mm
+#define SNAP_MAX_MM  2.0
+
+//How far back the pose history checks look, ms, and how close a past pose has
+//to be to the truth, mm and degrees
+#define LOOK_BACK_MS 240
+#define POSE_MAX_MM  0.2
+#define POSE_MAX_DEG 0.25
+
+//How close the wheel speeds have to be once settled, percent, and how soon
+//after a step they have to get there, ms
+#define SPEED_MAX_PCT  3.0
+#define SPEED_SETTLE   80
+
+//Limits of the nav task's drive moves, mm/s, mm/s^2 and mm/s^3
+#define PROFILE_VEL   250
+#define PROFILE_ACCEL 600
+#define PROFILE_JERK  6000
+
+//How far off the braking distance may be from what stopTarget() in the nav
+//task works out, percent
+#define STOP_MAX_PCT  10.0
+
+//Speed the pursuit checks drive at, mm/s, how close the curvature has to be
+//to 2 y / L^2, percent of the sharpest a goal on the look-ahead circle asks
+//for (2 / L), and how close the robot has to end to the last
+//waypoint, mm
+#define PURSUIT_SPEED    100
+#define CURVE_MAX_PCT    2.0
+#define ARRIVE_MAX_MM    10.0
+
+//Where the wall is in the wall filter checks, how often the sonar reads (ms),
+//and how far off the estimate may be, mm
+#define WALL_MM      1200.0
+#define SONAR_MS     60
+#define WALL_MAX_MM  10.0
+
+
+/**************************************************************************************
+ * Simulated robot
+ **************************************************************************************/
+/** @brief   A robot driving on a PC, with the real RobotClass tracking it
+ *  @details @c Step() moves the wheels along by one ms at the speeds given and
+ * 			 takes a sample, like the 1 ms interrupt. Every @c UPDATE_PERIOD ms
+ * 			 it updates @c Bot as well, like the nav task, and returns true.
+ */
+
+class SimBot
+{
+
+public:
+
+	//Starts at the origin facing along x, with the odometry starting at (x0, 0)
+	SimBot(double x0, double heading) : Bot(&Left, &Right)
+	{
+		Tick = 1000;
+		LeftDeg = RightDeg = 0.5;
+		X = x0;
+		Y = 0;
+		Theta = heading;
+
+		NNxt::HostSimTick() = Tick;
+		Bot.Reset();
+		Bot.Correct(FLOAT2Q16(x0), 0);
+		Bot.BotData.theta = (U32) (S32) (heading / M_PI * 2147483648.0);
+	}
+
+	//One ms at these wheel speeds, in degrees/s. True if Bot was updated.
+	bool Step(double left, double right)
+	{
+		for (U8 sub = 0; sub < 10; sub++)
+		{
+			double dl = left / 10000;
+			double dr = right / 10000;
+			double ds = (dl + dr) / 2 * MM_PER_DEG;
+			double dTheta = (dr - dl) * MM_PER_DEG / BASE_MM;
+
+			LeftDeg += dl;
+			RightDeg += dr;
+			X += ds * std::cos(Theta + dTheta / 2);
+			Y += ds * std::sin(Theta + dTheta / 2);
+			Theta += dTheta;
+		}
+
+		Tick++;
+		NNxt::HostSimTick() = Tick;
+		Left.setCount((S32) std::floor(LeftDeg));
+		Right.setCount((S32) std::floor(RightDeg));
+		Bot.Sample();
+
+		if (Tick % UPDATE_PERIOD != 0) {return false;}
+
+		Bot.Update();
+		return true;
+	}
+
+	//Bot's x less the true x, mm
+	double ErrorX(void)
+	{
+		return Bot.GetInfo().x / 65536.0 - X;
+	}
+
+	ecrobot::Motor Left;
+	ecrobot::Motor Right;
+	RobotClass Bot;
+
+	U32 Tick;
+	double LeftDeg;
+	double RightDeg;
+
+	//The truth
+	double X;
+	double Y;
+	double Theta;
+};
+
+
+/**************************************************************************************
+ * Pose history
+ **************************************************************************************/
+/** @brief   Check @c poseAt() finds where the robot was, and @c Correct() moves
+ * 			 the history with the pose
+ *  @details The robot drives a curve, so x, y and the heading all change, and
+ * 			 every ms of the last @c LOOK_BACK_MS is looked up against where it
+ * 			 truly was. A fix is then applied, which must move every past pose
+ * 			 by exactly the fix. Times newer and older than the history must give
+ * 			 the newest pose and a refusal.
+ *  @return  Number of things that failed
+ */
+
+U32 checkPoseHistory(void)
+{
+	SimBot sim(0, 0);
+	double truthX[LOOK_BACK_MS + 1];
+	double truthY[LOOK_BACK_MS + 1];
+	double truthTheta[LOOK_BACK_MS + 1];
+	RobotClass::PoseStamp before[LOOK_BACK_MS + 1];
+	RobotClass::PoseStamp pose;
+	double maxMm = 0;
+	double maxDeg = 0;
+	bool shifted = true;
+	bool newest;
+	bool tooOld;
+	U32 failed = 0;
+
+	printf("Pose history, %u ms looked up on a curve:\n", LOOK_BACK_MS);
+
+	//Long enough to fill the history, ending on an update
+	for (U32 ms = 1; ms <= 1000; ms++)
+	{
+		sim.Step(300, 200);
+
+		if (ms >= 1000 - LOOK_BACK_MS)
+		{
+			truthX[ms - (1000 - LOOK_BACK_MS)] = sim.X;
+			truthY[ms - (1000 - LOOK_BACK_MS)] = sim.Y;
+			truthTheta[ms - (1000 - LOOK_BACK_MS)] = sim.Theta;
+		}
+	}
+
+	for (U32 n = 0; n <= LOOK_BACK_MS; n++)
+	{
+		U32 tick = sim.Tick - LOOK_BACK_MS + n;
+		double dx, dy, dTheta;
+
+		sim.Bot.poseAt(tick, before[n]);
+
+		dx = before[n].x / 65536.0 - truthX[n];
+		dy = before[n].y / 65536.0 - truthY[n];
+		dTheta = (S32) (before[n].theta - (U32) (S32) (truthTheta[n] / M_PI * 2147483648.0)) / 2147483648.0 * 180;
+
+		if (std::sqrt(dx * dx + dy * dy) > maxMm) {maxMm = std::sqrt(dx * dx + dy * dy);}
+		if (std::fabs(dTheta) > maxDeg) {maxDeg = std::fabs(dTheta);}
+	}
+
+	//A fix must move the whole history with it
+	sim.Bot.Correct(INT2Q16(10), -INT2Q16(5));
+
+	for (U32 n = 0; n <= LOOK_BACK_MS; n++)
+	{
+		sim.Bot.poseAt(sim.Tick - LOOK_BACK_MS + n, pose);
+
+		if (pose.x != before[n].x + INT2Q16(10) || pose.y != before[n].y + -INT2Q16(5) || pose.theta != before[n].theta)
+		{
+			shifted = false;
+		}
+	}
+
+	newest = sim.Bot.poseAt(sim.Tick + 100, pose) && pose.x == sim.Bot.GetInfo().x && pose.theta == sim.Bot.GetInfo().theta;
+	tooOld = !sim.Bot.poseAt(sim.Tick - 1000, pose);
+
+	printf("  %-26s %10.2f mm%s\n", "worst position", maxMm, (maxMm <= POSE_MAX_MM) ? "" : "  FAIL");
+	printf("  %-26s %10.2f deg%s\n", "worst heading", maxDeg, (maxDeg <= POSE_MAX_DEG) ? "" : "  FAIL");
+	printf("  %-26s %10s%s\n", "history after a fix", shifted ? "moved" : "not moved", shifted ? "" : "  FAIL");
+	printf("  %-26s %10s%s\n", "newer than the history", newest ? "newest" : "wrong", newest ? "" : "  FAIL");
+	printf("  %-26s %10s%s\n", "older than the history", tooOld ? "refused" : "found", tooOld ? "" : "  FAIL");
+
+	failed += (maxMm > POSE_MAX_MM);
+	failed += (maxDeg > POSE_MAX_DEG);
+	failed += !shifted;
+	failed += !newest;
+	failed += !tooOld;
+
+	printf("%u pose history checks failed\n\n", failed);
+
+	return failed;
+}
+
+
+/**************************************************************************************
+ * Wheel speeds
+ **************************************************************************************/
+/** @brief   Worst of the two wheel speeds against the truth
+ *  @param   sim   The robot
+ *  @param   left  Left wheel's true speed, degrees/s
+ *  @param   right Right wheel's true speed, degrees/s
+ *  @return  Percent of the true speed, or mm/s when the truth is 0
+ */
+
+double speedError(SimBot& sim, double left, double right)
+{
+	Q16 gotLeft;
+	Q16 gotRight;
+	double errLeft;
+	double errRight;
+
+	sim.Bot.GetWheelSpeeds(gotLeft, gotRight);
+
+	errLeft = gotLeft / 65536.0 - left * MM_PER_DEG;
+	errRight = gotRight / 65536.0 - right * MM_PER_DEG;
+
+	if (left != 0) {errLeft *= 100 / (left * MM_PER_DEG);}
+	if (right != 0) {errRight *= 100 / (right * MM_PER_DEG);}
+
+	return (std::fabs(errLeft) > std::fabs(errRight)) ? std::fabs(errLeft) : std::fabs(errRight);
+}
+
+/** @brief   Drive at one speed and see how soon and how well it is tracked
+ *  @param   name   What the case is
+ *  @param   sim    The robot, carried on from the last case
+ *  @param   left   Left wheel speed, degrees/s
+ *  @param   right  Right wheel speed, degrees/s
+ *  @param   settle ms it may take to settle
+ *  @return  True if it did what it should
+ */
+
+bool checkSpeed(const char* name, SimBot& sim, double left, double right, U32 settle)
+{
+	double worst = 0;
+	double err;
+	bool ok;
+
+	for (U32 ms = 1; ms <= 1000; ms++)
+	{
+		if (!sim.Step(left, right) || ms <= settle) {continue;}
+
+		err = speedError(sim, left, right);
+
+		if (err > worst) {worst = err;}
+	}
+
+	ok = (left == 0 && right == 0) ? (worst == 0) : (worst <= SPEED_MAX_PCT);
+
+	printf("  %-26s %10.2f%s%s\n", name, worst, (left == 0 && right == 0) ? " mm/s" : " %", ok ? "" : "  FAIL");
+
+	return ok;
+}
+
+/** @brief   Check the alpha-beta filter at speed, the time between ticks when slow,
+ * 			 and that a stopped wheel reads 0
+ *  @details Each case starts from where the last one left off, so each is a
+ * 			 step in speed. Once the settle time is up, every update's speed has
+ * 			 to be within @c SPEED_MAX_PCT of the truth. A wheel stopped for
+ * 			 longer than the speed tracking waits for a tick has to read 0.
+ *  @return  Number of cases that failed
+ */
+
+U32 checkWheelSpeeds(void)
+{
+	SimBot sim(0, 0);
+	U32 failed = 0;
+
+	printf("Wheel speeds, worst error once settled:\n");
+
+	//300 degrees/s is about 100 mm/s, a tick every 3.3 ms
+	failed += !checkSpeed("from rest, 300 deg/s", sim, 300, 300, SPEED_SETTLE);
+	failed += !checkSpeed("turning, 400 and 150 deg/s", sim, 400, 150, SPEED_SETTLE);
+	failed += !checkSpeed("backing up, -300 deg/s", sim, -300, -300, SPEED_SETTLE);
+
+	//A tick every 67 ms, only the time between them can tell the speed
+	failed += !checkSpeed("creeping, 15 deg/s", sim, 15, 15, 300);
+	failed += !checkSpeed("stopped", sim, 0, 0, 300);
+
+	printf("%u wheel speed cases failed\n\n", failed);
+
+	return failed;
+}
+
+
+/**************************************************************************************
+ * Landmarks
+ **************************************************************************************/
+/** @brief   Drive one sensor over a line and see where the snap puts the robot
+ *  @details The line runs along y at @c LINE_MM. The odometry starts
+ * 			 @c START_ERR_MM ahead of the truth, so a snap has to take the error
+ * 			 out. The sensor sees the tape from the truth, as the nav task
+ * 			 reads it every update.
+ *  @param   name    What the case is
+ *  @param   x0      Where the robot starts, mm
+ *  @param   heading Which way it faces, rad
+ *  @param   left    Left wheel speed, degrees/s
+ *  @param   right   Right wheel speed, degrees/s
+ *  @param   snaps   How many snaps there should be
+ *  @return  True if it did what it should
+ */
+
+bool checkCrossing(const char* name, double x0, double heading, double left, double right, U32 snaps)
+{
+	const LandmarkClass::Line lines[] = {{LandmarkClass::LINE_X, FLOAT2Q16(LINE_MM)}};
+	const LandmarkClass::Sensor sensors[] = {{INT2Q16(76), 0, 500}};
+	SimBot sim(x0, heading);
+	LandmarkClass marks(&sim.Bot, lines, 1, sensors, 1);
+	double before = 0;
+	double after = 0;
+	bool ok;
+
+	sim.Bot.Correct(FLOAT2Q16(START_ERR_MM), 0);
+
+	for (U32 ms = 0; ms < 3000; ms++)
+	{
+		if (!sim.Step(left, right)) {continue;}
+
+		double sensorX = sim.X + 76 * std::cos(sim.Theta);
+		S16 brightness = (std::fabs(sensorX - LINE_MM) <= TAPE_HALF_MM) ? 600 : 400;
+
+		before = sim.ErrorX();
+
+		if (marks.Check(0, brightness, sim.Tick) && marks.GetSnapCount() == 1)
+		{
+			after = sim.ErrorX();
+		}
+	}
+
+	ok = (marks.GetSnapCount() == snaps && (snaps == 0 || std::fabs(after) <= SNAP_MAX_MM));
+
+	printf("  %-26s %6u %6u %10.2f %10.2f%s\n", name, marks.GetSnapCount(), marks.GetMissCount(),
+		   snaps ? after : before, before, ok ? "" : "  FAIL");
+
+	return ok;
+}
+
+/** @brief   Check line crossings going forward, backing up and turning in place
+ *  @return  Number of cases that failed
+ */
+
+U32 checkLandmarks(void)
+{
+	U32 failed = 0;
+
+	printf("Landmarks, line at x = %.0f mm, odometry %.0f mm off:\n", LINE_MM, START_ERR_MM);
+	printf("  %-26s %6s %6s %10s %10s\n", "case", "snaps", "misses", "snap mm", "end mm");
+
+	//300 degrees/s is about 100 mm/s
+	failed += !checkCrossing("forward", 300, 0, 300, 300, 1);
+	failed += !checkCrossing("backing up", 600, 0, -300, -300, 1);
+	failed += !checkCrossing("forward, facing -x", 600, M_PI, 300, 300, 1);
+	failed += !checkCrossing("turning in place", LINE_MM - 60, M_PI / 2, 200, -200, 0);
+
+	printf("%u landmark cases failed\n\n", failed);
+
+	return failed;
+}
+
+
+/**************************************************************************************
+ * Profile
+ **************************************************************************************/
+/** @brief   Run one move and check it keeps to the limits and stops on the target
+ *  @details The profile is stepped every @c UPDATE_PERIOD ms like the nav task
+ * 			 does. Speed, accel and the change in accel from one step to the
+ * 			 next must stay inside the limits, the move must not pass the target
+ * 			 by more than the profile's settling band, and it must finish. For a
+ * 			 move long enough to reach top speed, the distance it takes to stop
+ * 			 from there is checked against v^2/2A + vA/2J, which the nav task's
+ * 			 @c stopTarget() uses.
+ *  @param   name     What the case is
+ *  @param   distance Length of the move, mm
+ *  @param   moveTo   Where to move the target to halfway through, mm, 0 to leave it
+ *  @return  True if it did what it should
+ */
+
+bool checkMove(const char* name, double distance, double moveTo)
+{
+	const ProfileClass::Limits limits = {INT2Q16(PROFILE_VEL), INT2Q16(PROFILE_ACCEL), INT2Q16(PROFILE_JERK)};
+	ProfileClass profile(limits);
+	double target = distance;
+	double sign = (distance < 0) ? -1 : 1;
+	double topVel = 0;
+	double topAccel = 0;
+	double topJerk = 0;
+	double overshoot = 0;
+	double brakeStart = 0;
+	double stopErr = 0;
+	double lastAccel = 0;
+	double pos;
+	double vel;
+	double accel;
+	bool done = false;
+	bool ok;
+	U32 ms;
+
+	profile.Start(FLOAT2Q16(distance));
+
+	for (ms = UPDATE_PERIOD; ms <= 20000 && !done; ms += UPDATE_PERIOD)
+	{
+		if (moveTo != 0 && ms == 1000)
+		{
+			target = moveTo;
+			profile.SetTarget(FLOAT2Q16(moveTo));
+		}
+
+		done = profile.Step(UPDATE_PERIOD);
+
+		pos = profile.GetPos() / 65536.0;
+		vel = profile.GetVel() / 65536.0;
+		accel = profile.GetAccel() / 65536.0;
+
+		if (std::fabs(vel) > topVel) {topVel = std::fabs(vel);}
+		if (std::fabs(accel) > topAccel) {topAccel = std::fabs(accel);}
+		if (std::fabs(accel - lastAccel) * 1000 / UPDATE_PERIOD > topJerk) {topJerk = std::fabs(accel - lastAccel) * 1000 / UPDATE_PERIOD;}
+		if ((pos - target) * sign > overshoot) {overshoot = (pos - target) * sign;}
+
+		//Where it starts to brake from top speed
+		if (brakeStart == 0 && topVel >= PROFILE_VEL - 1 && std::fabs(vel) < topVel)
+		{
+			brakeStart = pos - vel * UPDATE_PERIOD / 1000;
+		}
+
+		lastAccel = accel;
+	}
+
+	if (brakeStart != 0)
+	{
+		double braking = (target - brakeStart) * sign;
+		double predicted = (double) PROFILE_VEL * PROFILE_VEL / (2 * PROFILE_ACCEL) + (double) PROFILE_VEL * PROFILE_ACCEL / (2 * PROFILE_JERK);
+
+		stopErr = (braking - predicted) * 100 / predicted;
+	}
+
+	ok = done && topVel <= PROFILE_VEL + 0.01 && topAccel <= PROFILE_ACCEL + 0.01 &&
+		 topJerk <= PROFILE_JERK + 0.01 && overshoot <= 0.5 && std::fabs(stopErr) <= STOP_MAX_PCT;
+
+	printf("  %-26s %6.0f %6.0f %6.0f %7.0f %6.2f %6.1f%s\n", name, topVel, topAccel, topJerk,
+		   done ? (double) ms - UPDATE_PERIOD : -1.0, overshoot, stopErr, ok ? "" : "  FAIL");
+
+	return ok;
+}
+
+/** @brief   Check the drive profile on long, short, backward and moved moves
+ *  @return  Number of cases that failed
+ */
+
+U32 checkProfile(void)
+{
+	U32 failed = 0;
+
+	printf("Profile, limits %u mm/s, %u mm/s^2, %u mm/s^3:\n", PROFILE_VEL, PROFILE_ACCEL, PROFILE_JERK);
+	printf("  %-26s %6s %6s %6s %7s %6s %6s\n", "case", "vel", "accel", "jerk", "ms", "over", "stop %");
+
+	failed += !checkMove("1000 mm", 1000, 0);
+	failed += !checkMove("50 mm, too short for top", 50, 0);
+	failed += !checkMove("back 600 mm", -600, 0);
+	failed += !checkMove("400 mm moved out to 900", 400, 900);
+	failed += !checkMove("900 mm moved in to 500", 900, 500);
+
+	printf("%u profile cases failed\n\n", failed);
+
+	return failed;
+}
+
+
+/**************************************************************************************
+ * Pursuit
+ **************************************************************************************/
+/** @brief   Check the curvature of one steer against pure pursuit's 2 y / L^2
+ *  @details The robot is at the origin facing along x, and the path is one
+ * 			 segment from there to a waypoint. The goal point is a look-ahead
+ * 			 along the segment, so the curvature is known from the angle of the
+ * 			 segment alone.
+ *  @param   name What the case is
+ *  @param   x    Where the waypoint is, mm
+ *  @param   y    Where the waypoint is, mm
+ *  @return  True if it did what it should
+ */
+
+bool checkCurve(const char* name, double x, double y)
+{
+	const PursuitClass::Point path[] = {{FLOAT2Q16(x), FLOAT2Q16(y), 0}};
+	SimBot sim(0, 0);
+	PursuitClass pursuit(&sim.Bot);
+	double look = 80 + 0.4 * PURSUIT_SPEED;
+	double want = 2 * (look * std::sin(std::atan2(y, x))) / (look * look);
+	double got;
+	double err;
+	Q16 left;
+	Q16 right;
+	bool ok;
+
+	pursuit.Start(path, 1);
+	pursuit.Steer(INT2Q16(PURSUIT_SPEED), left, right);
+
+	//Curvature of the arc the wheels drive: (right - left) / (base v)
+	got = (right - left) / 65536.0 / (BASE_MM * PURSUIT_SPEED);
+	err = (got - want) * 100 / (2 / look);
+
+	ok = std::fabs(err) <= CURVE_MAX_PCT;
+
+	printf("  %-26s %10.5f %10.5f %8.2f%s\n", name, want, got, err, ok ? "" : "  FAIL");
+
+	return ok;
+}
+
+/** @brief   Follow a path with the robot driving the wheel speeds it is given
+ *  @details Steers every @c UPDATE_PERIOD ms at @c PURSUIT_SPEED, until the
+ * 			 pursuit says it has arrived or 20 s are up.
+ *  @param   name  What the case is
+ *  @param   path  The waypoints
+ *  @param   count How many there are
+ *  @return  True if it arrived within @c ARRIVE_MAX_MM of the last waypoint
+ */
+
+bool checkFollow(const char* name, const PursuitClass::Point* path, U8 count)
+{
+	SimBot sim(0, 0);
+	PursuitClass pursuit(&sim.Bot);
+	double left = 0;
+	double right = 0;
+	double off;
+	bool arrived = false;
+	bool ok;
+	U32 ms;
+	Q16 qLeft;
+	Q16 qRight;
+
+	pursuit.Start(path, count);
+
+	for (ms = 1; ms <= 20000 && !arrived; ms++)
+	{
+		if (!sim.Step(left, right)) {continue;}
+
+		arrived = pursuit.Steer(INT2Q16(PURSUIT_SPEED), qLeft, qRight);
+
+		left = qLeft / 65536.0 / MM_PER_DEG;
+		right = qRight / 65536.0 / MM_PER_DEG;
+	}
+
+	off = std::sqrt((sim.X - path[count - 1].x / 65536.0) * (sim.X - path[count - 1].x / 65536.0) +
+					(sim.Y - path[count - 1].y / 65536.0) * (sim.Y - path[count - 1].y / 65536.0));
+
+	ok = arrived && off <= ARRIVE_MAX_MM;
+
+	printf("  %-26s %10s %10.2f%s\n", name, arrived ? "arrived" : "lost", off, ok ? "" : "  FAIL");
+
+	return ok;
+}
+
+/** @brief   Check the steering curvature, and follow paths to the end
+ *  @return  Number of cases that failed
+ */
+
+U32 checkPursuit(void)
+{
+	const PursuitClass::Point ahead[] = {{INT2Q16(600), INT2Q16(200), 0}};
+	const PursuitClass::Point corner[] = {{INT2Q16(400), 0, 0}, {INT2Q16(400), INT2Q16(400), 0}};
+	const PursuitClass::Point zigzag[] = {{INT2Q16(300), -INT2Q16(150), 0}, {INT2Q16(600), INT2Q16(150), 0},
+										  {INT2Q16(900), 0, 0}};
+	const PursuitClass::Point behind[] = {{-INT2Q16(400), 0, 0}};
+	const PursuitClass::Point behindRight[] = {{-INT2Q16(300), -INT2Q16(200), 0}};
+	const PursuitClass::Point beside[] = {{0, INT2Q16(300), 0}};
+	U32 failed = 0;
+
+	printf("Pursuit, curvature of the first steer at %u mm/s, 1/mm:\n", PURSUIT_SPEED);
+	printf("  %-26s %10s %10s %8s\n", "case", "2y/L^2", "steered", "% of 2/L");
+
+	failed += !checkCurve("straight ahead", 500, 0);
+	failed += !checkCurve("20 degrees left", 500 * std::cos(0.349), 500 * std::sin(0.349));
+	failed += !checkCurve("45 degrees right", 500, -500);
+
+	printf("Pursuit, following paths to the last waypoint:\n");
+	printf("  %-26s %10s %10s\n", "case", "", "off mm");
+
+	failed += !checkFollow("one waypoint ahead", ahead, 1);
+	failed += !checkFollow("square corner", corner, 2);
+	failed += !checkFollow("zigzag", zigzag, 3);
+	failed += !checkFollow("straight behind", behind, 1);
+	failed += !checkFollow("behind and right", behindRight, 1);
+	failed += !checkFollow("beside, to the left", beside, 1);
+
+	printf("%u pursuit cases failed\n\n", failed);
+
+	return failed;
+}
+
+
+/**************************************************************************************
+ * Wall filter
+ **************************************************************************************/
+/** @brief   Sonar reading of the wall from where the robot truly is
+ *  @param   sim  The robot
+ *  @param   wall Where the wall is, mm
+ *  @return  Whole cm, as the sonar reads
+ */
+
+S16 sonarCm(SimBot& sim, double wall)
+{
+	return (S16) std::floor((wall - sim.X) / 10 + 0.5);
+}
+
+/** @brief   Check the wall filter follows the wall, ignores landmark fixes, and
+ * 			 throws out or starts over on bad readings
+ *  @details The robot drives at the wall at about 100 mm/s with a reading every
+ * 			 @c SONAR_MS ms. After 1 s a landmark fix moves the pose 30 mm,
+ * 			 which is not driving, so the estimate must not move. After 2 s one
+ * 			 wild reading comes, which must be thrown away. After 3 s a box
+ * 			 300 mm closer than the wall shows up, and the filter must start over
+ * 			 on it within @c REJECT_LIMIT (3) readings.
+ *  @return  Number of things that failed
+ */
+
+U32 checkWallFilter(void)
+{
+	SimBot sim(0, 0);
+	WallFilterClass filter(&sim.Bot);
+	double wall = WALL_MM;
+	double err;
+	double maxErr = 0;
+	double fixErr = 0;
+	bool started = false;
+	bool wildKept = false;
+	U16 wildRejects = 0;
+	U32 boxReadings = 0;
+	U32 sinceBox = 0;
+	U32 boxTaken = 0;
+	U32 failed = 0;
+
+	printf("Wall filter, wall at x = %.0f mm:\n", WALL_MM);
+
+	for (U32 ms = 1; ms <= 4000; ms++)
+	{
+		if (!sim.Step(300, 300)) {continue;}
+
+		//A landmark fix, after which the estimate must stay where it was
+		if (ms == 1000)
+		{
+			sim.Bot.Correct(INT2Q16(30), 0);
+		}
+
+		if (started) {filter.Predict();}
+
+		if (ms % SONAR_MS == 0)
+		{
+			S16 cm = sonarCm(sim, wall);
+
+			if (!started)
+			{
+				started = filter.Start(cm, sim.Tick);
+			}
+			else if (ms == 2040)
+			{
+				wildKept = filter.Measure(cm / 3, sim.Tick);
+				wildRejects = filter.GetRejects();
+			}
+			else
+			{
+				if (ms >= 3000 && boxReadings < 3)
+				{
+					wall = WALL_MM - 300;
+					cm = sonarCm(sim, wall);
+					boxReadings++;
+				}
+
+				filter.Measure(cm, sim.Tick);
+
+				//Readings until the filter is on the box
+				if (boxReadings > 0) {sinceBox++;}
+
+				if (sinceBox > 0 && boxTaken == 0 &&
+					std::fabs(filter.GetDistance() / 65536.0 - (wall - sim.X)) <= WALL_MAX_MM)
+				{
+					boxTaken = sinceBox;
+				}
+			}
+		}
+
+		if (!started) {continue;}
+
+		err = filter.GetDistance() / 65536.0 - (wall - sim.X);
+
+		if (ms > 1000 && ms <= 1100 && std::fabs(err) > fixErr) {fixErr = std::fabs(err);}
+		if ((ms < 3000 || boxReadings >= 3) && std::fabs(err) > maxErr) {maxErr = std::fabs(err);}
+	}
+
+	printf("  %-26s %10.2f mm%s\n", "worst error after a fix", fixErr, (fixErr <= WALL_MAX_MM) ? "" : "  FAIL");
+	printf("  %-26s %10s%s\n", "wild reading", wildKept ? "kept" : "thrown out", wildKept ? "  FAIL" : "");
+	printf("  %-26s %10u%s\n", "rejects counted", wildRejects, (wildRejects == 1) ? "" : "  FAIL");
+	printf("  %-26s %10u%s\n", "readings to take the box", boxTaken, (boxTaken >= 1 && boxTaken <= 3) ? "" : "  FAIL");
+	printf("  %-26s %10.2f mm%s\n", "worst error, box and all", maxErr, (maxErr <= WALL_MAX_MM) ? "" : "  FAIL");
+
+	failed += (fixErr > WALL_MAX_MM);
+	failed += wildKept;
+	failed += (wildRejects != 1);
+	failed += (boxTaken < 1 || boxTaken > 3);
+	failed += (maxErr > WALL_MAX_MM);
+
+	printf("%u wall filter checks failed\n\n", failed);
+
+	return failed;
+}
+
+
+/**************************************************************************************
+ * Main
+ **************************************************************************************/
+
+int main(void)
+{
+	U32 failed = 0;
+
+	failed += checkPoseHistory();
+	failed += checkWheelSpeeds();
+	failed += checkLandmarks();
+	failed += checkWallFilter();
+	failed += checkProfile();
+	failed += checkPursuit();
+
+	printf("%u checks failed\n", failed);
+
+	return (failed == 0) ? 0 : 1;
+}
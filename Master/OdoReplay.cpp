@@ -0,0 +1,601 @@
+//*************************************************************************************
+/** @file    OdoReplay.cpp
+ *  @brief   Runs RobotClass on a PC to measure how good the odometry is
+ *  @details This is not part of the Master brick's build. It compiles the real
+ * 			 @c RobotClass against the simulated motors in lib/MotorSim.hpp and
+ * 			 feeds it encoder samples the same way the 1 ms interrupt and the
+ * 			 nav task do: @c Sample() every ms and @c Update() every 20 ms.
+ *
+ * 			 With no arguments it drives a set of made up trajectories, where
+ * 			 the true path is known, and prints for each one the error of
+ * 			 \li @c RobotClass (Q16, exact arc every sample)
+ * 			 \li A double precision exact arc every sample, which shows what
+ * 				 the fixed point costs
+ * 			 \li A double precision Euler step every sample and every update,
+ * 				 which shows what the integrator is worth
+ * 			 along with the time @c Update() took on the PC. The last
+ * 			 trajectory runs for ten minutes to check nothing drifts or
+ * 			 overflows.
+ *
+ * 			 It then checks single long steps, like those after a gap between
+ * 			 samples: one sample takes the robot along an arc of up to many
+ * 			 turns, and @c RobotClass must end where the exact arc in double
+ * 			 precision does. It exits with 1 if any step is off by more than
+ * 			 @c STEP_MAX_MM or @c STEP_MAX_DEG.
+ *
+ * 			 Given a log file it replays it instead and compares @c RobotClass
+ * 			 with the double precision arc, since the true path isn't known.
+ * 			 Each line of the log is the tick in ms and the left and right
+ * 			 encoder counts, separated by spaces. Lines starting with # are
+ * 			 skipped.
+ *
+ * 			 Build and run with:
+ * 			 @code
+ * 			 g++ -O2 -DHOST_BUILD -I../lib OdoReplay.cpp -o OdoReplay -lpthread
+ * 			 ./OdoReplay [log.txt]
+ * 			 @endcode
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *	  \li 10-18-2026 ARB Checks single long steps against the exact arc
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+#ifndef HOST_BUILD
+#error OdoReplay.cpp only builds on a PC, with -DHOST_BUILD
+#endif
+
+#include <cstdio>
+#include <cmath>
+
+#include "RobotClass.hpp"
+
+
+/**************************************************************************************
+ * Constants
+ **************************************************************************************/
+
+//ms between calls to Update(), the nav task's period
+#define UPDATE_PERIOD 20
+
+//Number of made up trajectories
+#define NUM_TRAJECTORIES 5
+
+//Number of long steps, and how far off RobotClass may end from the exact arc
+#define NUM_STEPS    14
+#define STEP_MAX_MM  0.5
+#define STEP_MAX_DEG 0.05
+
+//The robot the made up trajectories are driven by
+#define MM_PER_DEG (RobotClass::WHEEL_RAD / 65536.0 * 2 * M_PI / 360)
+#define BASE_MM    (RobotClass::WHEEL_BASE / 65536.0)
+
+
+/**************************************************************************************
+ * Types
+ **************************************************************************************/
+
+//Part of a made up trajectory, with both wheels at a steady speed
+struct Segment
+{
+	U32 ms;          /**<How long it lasts*/
+	double left;     /**<Left wheel speed, degrees/s*/
+	double right;    /**<Right wheel speed, degrees/s*/
+};
+
+//A made up trajectory
+struct Trajectory
+{
+	const char* name;
+	const Segment* segments;
+	U8 numSegments;
+	U8 repeats;      /**<Times to run through the segments*/
+};
+
+//A pose in doubles
+struct Pose
+{
+	double x;        /**<mm*/
+	double y;        /**<mm*/
+	double theta;    /**<rad*/
+};
+
+//Error of one integrator against the reference
+struct Score
+{
+	double maxPos;   /**<Largest position error seen at an update, mm*/
+	double endPos;   /**<Position error at the end, mm*/
+	double endTheta; /**<Heading error at the end, degrees*/
+};
+
+
+//A single long step, in one sample
+struct LongStep
+{
+	double mm;       /**<Distance the middle of the robot goes*/
+	double deg;      /**<Turn, positive to the left*/
+};
+
+
+/**************************************************************************************
+ * Trajectories
+ **************************************************************************************/
+
+const Segment Straight[] = {{500, 0, 0}, {5000, 300, 300}, {500, 0, 0}};
+
+const Segment Spin[] = {{4000, -200, 200}, {4000, 200, -200}};
+
+const Segment Arc[] = {{10000, 200, 300}};
+
+const Segment Course[] =
+{
+	{3000, 400, 400},   //Cross the field
+	{1500, -150, 150},  //Turn left
+	{2000, 300, 450},   //Sweep left
+	{2000, 450, 300},   //and back right
+	{1000, 0, 0},       //Stop at the wall
+	{2000, -250, -250}, //Back up
+	{3000, -100, 100}   //Turn around
+};
+
+//Full circles either way, so the robot stays on the field
+const Segment Loops[] = {{21120, 250, 350}, {21120, 350, 250}};
+
+const Trajectory Trajectories[NUM_TRAJECTORIES] =
+{
+	{"Straight",     Straight, 3, 1},
+	{"Spin",         Spin,     2, 1},
+	{"Arc",          Arc,      1, 1},
+	{"Course",       Course,   7, 1},
+	{"Loops 10 min", Loops,    2, 14}
+};
+
+
+//From a tick to whole turns in place, and the same with driving along
+const LongStep LongSteps[NUM_STEPS] =
+{
+	{0, 0}, {1, 0}, {1000, 0}, {500, 45},
+	{0, 89}, {0, -91}, {0, 179}, {0, -181}, {300, 270},
+	{0, 360}, {200, -720}, {0, 1000}, {1500, 2500}, {0, -2500}
+};
+
+
+/**************************************************************************************
+ * Reference integrators
+ **************************************************************************************/
+/** @brief   Move a pose along by one step, in doubles
+ *  @param   pose  The pose
+ *  @param   dl    Left wheel distance, mm
+ *  @param   dr    Right wheel distance, mm
+ *  @param   base  Wheel base, mm
+ *  @param   exact True for the exact arc, false for an Euler step
+ */
+
+void step(Pose& pose, double dl, double dr, double base, bool exact)
+{
+	double ds = (dl + dr) / 2;
+	double dTheta = (dr - dl) / base;
+
+	if (exact)
+	{
+		double half = dTheta / 2;
+		double chord = (std::fabs(half) < 1e-9) ? ds : ds * std::sin(half) / half;
+
+		pose.x += chord * std::cos(pose.theta + half);
+		pose.y += chord * std::sin(pose.theta + half);
+	}
+	else
+	{
+		pose.x += ds * std::cos(pose.theta);
+		pose.y += ds * std::sin(pose.theta);
+	}
+
+	pose.theta += dTheta;
+}
+
+
+/**************************************************************************************
+ * Scoring
+ **************************************************************************************/
+/** @brief   Compare a pose with the reference and keep the worst error
+ */
+
+void score(Score& s, const Pose& pose, const Pose& ref, bool end)
+{
+	double err = std::sqrt((pose.x - ref.x) * (pose.x - ref.x) + (pose.y - ref.y) * (pose.y - ref.y));
+	double dTheta = std::remainder(pose.theta - ref.theta, 2 * M_PI);
+
+	if (err > s.maxPos) {s.maxPos = err;}
+
+	if (end)
+	{
+		s.endPos = err;
+		s.endTheta = dTheta * 180 / M_PI;
+	}
+}
+
+/** @brief   RobotClass's pose in doubles
+ */
+
+Pose botPose(RobotClass& bot)
+{
+	RobotClass::RectData data = bot.GetInfo();
+	Pose pose;
+
+	pose.x = data.x / 65536.0;
+	pose.y = data.y / 65536.0;
+	pose.theta = (S32) data.theta * (M_PI / 2147483648.0);
+
+	return pose;
+}
+
+/** @brief   Time in ns, for timing Update()
+ */
+
+double nowNs(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+
+/**************************************************************************************
+ * Replay
+ **************************************************************************************/
+/** @brief   Runs RobotClass and the reference integrators over the same samples
+ *  @details Each call to @c Feed() is one 1 ms interrupt. The truth, if there
+ * 			 is one, is handed in with it.
+ */
+
+class Replay
+{
+
+public:
+
+	Replay(void) : Bot(&Left, &Right)
+	{
+		Q16 rad;
+		Q16 base;
+
+		Bot.GetGeometry(rad, base);
+		MmPerDeg = rad / 65536.0 * 2 * M_PI / 360;
+		Base = base / 65536.0;
+
+		ArcD.x = ArcD.y = ArcD.theta = 0;
+		Euler1 = Euler20 = ArcD;
+
+		BotScore.maxPos = BotScore.endPos = BotScore.endTheta = 0;
+		ArcScore = Euler1Score = Euler20Score = BotScore;
+
+		Started = false;
+		Updates = 0;
+		CostSum = 0;
+		CostMax = 0;
+	}
+
+	//One interrupt's worth: the encoders read lCount and rCount at tick
+	void Feed(U32 tick, S32 lCount, S32 rCount, const Pose* p_Truth, bool end)
+	{
+		NNxt::HostSimTick() = tick;
+		Left.setCount(lCount);
+		Right.setCount(rCount);
+
+		if (!Started)
+		{
+			Bot.Reset();
+			LastL = BatchL = lCount;
+			LastR = BatchR = rCount;
+			Started = true;
+			return;
+		}
+
+		Bot.Sample();
+
+		step(ArcD, (lCount - LastL) * MmPerDeg, (rCount - LastR) * MmPerDeg, Base, true);
+		step(Euler1, (lCount - LastL) * MmPerDeg, (rCount - LastR) * MmPerDeg, Base, false);
+		LastL = lCount;
+		LastR = rCount;
+
+		if (tick % UPDATE_PERIOD == 0 || end)
+		{
+			double start = nowNs();
+			Bot.Update();
+			double cost = nowNs() - start;
+
+			CostSum += cost;
+			if (cost > CostMax) {CostMax = cost;}
+			Updates++;
+
+			step(Euler20, (lCount - BatchL) * MmPerDeg, (rCount - BatchR) * MmPerDeg, Base, false);
+			BatchL = lCount;
+			BatchR = rCount;
+
+			//Without the truth, the double arc is the reference
+			const Pose& ref = (p_Truth != NULL) ? *p_Truth : ArcD;
+
+			score(BotScore, botPose(Bot), ref, end);
+			score(ArcScore, ArcD, ref, end);
+			score(Euler1Score, Euler1, ref, end);
+			score(Euler20Score, Euler20, ref, end);
+		}
+	}
+
+	//Print the results
+	void Report(const char* name, bool haveTruth)
+	{
+		printf("%s, %u updates, Update() %.2f us mean %.2f us max, %u overruns\n", name, Updates,
+			   CostSum / Updates / 1000, CostMax / 1000, Bot.GetSampleOverruns());
+		printf("  %-22s %10s %10s %12s\n", "vs truth:", "max mm", "end mm", "end deg");
+
+		if (!haveTruth)
+		{
+			printf("  (no truth, compared with the double arc)\n");
+		}
+
+		Line("RobotClass Q16 arc", BotScore);
+
+		if (haveTruth)
+		{
+			Line("double arc 1 ms", ArcScore);
+		}
+
+		Line("double Euler 1 ms", Euler1Score);
+		Line("double Euler 20 ms", Euler20Score);
+		printf("\n");
+	}
+
+protected:
+
+	void Line(const char* name, const Score& s)
+	{
+		printf("  %-22s %10.3f %10.3f %12.4f\n", name, s.maxPos, s.endPos, s.endTheta);
+	}
+
+	ecrobot::Motor Left;
+	ecrobot::Motor Right;
+	RobotClass Bot;
+
+	double MmPerDeg;
+	double Base;
+
+	Pose ArcD;
+	Pose Euler1;
+	Pose Euler20;
+
+	Score BotScore;
+	Score ArcScore;
+	Score Euler1Score;
+	Score Euler20Score;
+
+	bool Started;
+	S32 LastL;
+	S32 LastR;
+	S32 BatchL;
+	S32 BatchR;
+
+	U32 Updates;
+	double CostSum;
+	double CostMax;
+};
+
+
+/**************************************************************************************
+ * Made up trajectories
+ **************************************************************************************/
+/** @brief   Drive one made up trajectory
+ *  @details The wheels turn smoothly and the encoders read the whole degrees,
+ * 			 like the real ones. The truth is the exact arc on the smooth
+ * 			 wheel angles, stepped every 0.1 ms.
+ */
+
+void runTrajectory(const Trajectory& traj)
+{
+	Replay replay;
+	Pose truth = {0, 0, 0};
+	double left = 0.5;
+	double right = 0.5;
+	U32 tick = 1000;
+	U32 total = 0;
+	U32 done = 0;
+
+	for (U8 r = 0; r < traj.repeats; r++)
+	{
+		for (U8 n = 0; n < traj.numSegments; n++)
+		{
+			total += traj.segments[n].ms;
+		}
+	}
+
+	replay.Feed(tick, 0, 0, &truth, false);
+
+	for (U8 r = 0; r < traj.repeats; r++)
+	{
+		for (U8 n = 0; n < traj.numSegments; n++)
+		{
+			const Segment& seg = traj.segments[n];
+
+			for (U32 ms = 0; ms < seg.ms; ms++)
+			{
+				for (U8 sub = 0; sub < 10; sub++)
+				{
+					double dl = seg.left / 10000;
+					double dr = seg.right / 10000;
+
+					left += dl;
+					right += dr;
+					step(truth, dl * MM_PER_DEG, dr * MM_PER_DEG, BASE_MM, true);
+				}
+
+				tick++;
+				done++;
+				replay.Feed(tick, (S32) std::floor(left), (S32) std::floor(right), &truth, done == total);
+			}
+		}
+	}
+
+	replay.Report(traj.name, true);
+}
+
+
+/**************************************************************************************
+ * Long steps
+ **************************************************************************************/
+/** @brief   Check RobotClass over single long steps
+ *  @details Both wheels turn at a steady speed for the whole step, so the
+ * 			 exact arc in doubles over the whole ticks is the truth.
+ *  @return  Number of steps that were too far off
+ */
+
+U32 checkLongSteps(void)
+{
+	U32 failed = 0;
+
+	printf("Long steps, one sample each, vs the exact arc:\n");
+	printf("  %8s %8s %8s %8s %10s %10s\n", "mm", "deg", "left", "right", "err mm", "err deg");
+
+	for (U8 n = 0; n < NUM_STEPS; n++)
+	{
+		ecrobot::Motor left;
+		ecrobot::Motor right;
+		RobotClass bot(&left, &right);
+		Pose truth = {0, 0, 0};
+		Q16 rad;
+		Q16 baseQ16;
+
+		bot.GetGeometry(rad, baseQ16);
+
+		double mmPerDeg = rad / 65536.0 * 2 * M_PI / 360;
+		double base = baseQ16 / 65536.0;
+		double sum = 2 * LongSteps[n].mm / mmPerDeg;
+		double diff = LongSteps[n].deg * M_PI / 180 * base / mmPerDeg;
+		S32 dl = (S32) std::floor((sum - diff) / 2 + 0.5);
+		S32 dr = (S32) std::floor((sum + diff) / 2 + 0.5);
+
+		NNxt::HostSimTick() = 1000;
+		left.setCount(0);
+		right.setCount(0);
+		bot.Reset();
+
+		NNxt::HostSimTick() = 1020;
+		left.setCount(dl);
+		right.setCount(dr);
+		bot.Sample();
+		bot.Update();
+
+		step(truth, dl * mmPerDeg, dr * mmPerDeg, base, true);
+
+		Pose got = botPose(bot);
+		double err = std::sqrt((got.x - truth.x) * (got.x - truth.x) + (got.y - truth.y) * (got.y - truth.y));
+		double errDeg = std::remainder(got.theta - truth.theta, 2 * M_PI) * 180 / M_PI;
+		bool ok = (err <= STEP_MAX_MM && std::fabs(errDeg) <= STEP_MAX_DEG);
+
+		if (!ok) {failed++;}
+
+		printf("  %8.0f %8.0f %8d %8d %10.4f %10.5f%s\n", LongSteps[n].mm, LongSteps[n].deg, dl, dr, err, errDeg, ok ? "" : "  FAIL");
+	}
+
+	printf("%u of %u long steps off by more than %.2f mm or %.2f deg\n\n", failed, NUM_STEPS, STEP_MAX_MM, STEP_MAX_DEG);
+
+	return failed;
+}
+
+
+/**************************************************************************************
+ * Log replay
+ **************************************************************************************/
+/** @brief   Replay a logged run
+ *  @param   fileName The log
+ *  @return  False if it couldn't be read
+ */
+
+bool runLog(const char* fileName)
+{
+	FILE* p_File = fopen(fileName, "r");
+	char line[128];
+	unsigned long tick;
+	long lCount;
+	long rCount;
+	bool have = false;
+	U32 lastTick = 0;
+	S32 lastL = 0;
+	S32 lastR = 0;
+	Replay replay;
+
+	if (p_File == NULL)
+	{
+		printf("Can't open %s\n", fileName);
+		return false;
+	}
+
+	//Each record is fed when the next one is read, so the last can be marked as the end
+	while (fgets(line, sizeof(line), p_File) != NULL)
+	{
+		if (line[0] == '#' || sscanf(line, "%lu %ld %ld", &tick, &lCount, &rCount) != 3)
+		{
+			continue;
+		}
+
+		if (have)
+		{
+			replay.Feed(lastTick, lastL, lastR, NULL, false);
+		}
+
+		lastTick = (U32) tick;
+		lastL = (S32) lCount;
+		lastR = (S32) rCount;
+		have = true;
+	}
+
+	fclose(p_File);
+
+	if (!have)
+	{
+		printf("No records in %s\n", fileName);
+		return false;
+	}
+
+	replay.Feed(lastTick, lastL, lastR, NULL, true);
+	replay.Report(fileName, false);
+
+	return true;
+}
+
+
+/**************************************************************************************
+ * Main
+ **************************************************************************************/
+
+int main(int argc, char** argv)
+{
+	if (argc > 1)
+	{
+		return runLog(argv[1]) ? 0 : 1;
+	}
+
+	printf("Wheel radius %.2f mm, wheel base %.2f mm, 1 degree encoders.\n", MM_PER_DEG * 360 / (2 * M_PI), BASE_MM);
+	printf("Q16 positions wrap at +-32.7 m.\n\n");
+
+	for (U8 n = 0; n < NUM_TRAJECTORIES; n++)
+	{
+		runTrajectory(Trajectories[n]);
+	}
+
+	return (checkLongSteps() == 0) ? 0 : 1;
+}
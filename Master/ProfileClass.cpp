@@ -0,0 +1,249 @@
+//*************************************************************************************
+/** @file    ProfileClass.cpp
+ *  @brief   Cpp file for the motion profile class
+ *  @details Steps a jerk limited profile towards its target.
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+//Need header file for the class
+#include "ProfileClass.hpp"
+
+/**************************************************************************************
+ * Constants
+ **************************************************************************************/
+
+//Close enough to the target to call it done, Q16 units
+#define DONE_POS 32768 //0.5
+
+//Slow enough to call it done, Q16 units/s
+#define DONE_VEL 65536 //1
+
+//Accel asked for per unit/s short of the speed wanted, in units of J / A (1/s).
+//J / A is as fast as the jerk limit lets the accel follow.
+#define ACCEL_GAIN 4
+
+
+/**************************************************************************************
+ * Constructor
+ **************************************************************************************/
+/** @brief  Class constructor
+ *  @details Starts at rest with nothing to do.
+ * 	@param   limits How hard a move may be
+ */
+
+	ProfileClass::ProfileClass(const Limits& limits)
+	{
+		Lim = limits;
+		Reset();
+	}
+	
+	
+/**************************************************************************************
+ * Set Limits
+ **************************************************************************************/
+/** @brief  Change the limits
+ * 	@param   limits How hard a move may be
+ */
+	
+	void ProfileClass::SetLimits(const Limits& limits)
+	{
+		Lim = limits;
+	}
+	
+	
+/**************************************************************************************
+ * Start
+ **************************************************************************************/
+/** @brief  Start a move of some distance from here
+ *  @details The position starts again from zero but the speed and accel are
+ *			 kept, so a new move can follow on from one that hasn't finished.
+ * 	@param   distance How far to go, negative to go backwards
+ */
+	
+	void ProfileClass::Start(Q16 distance)
+	{
+		Pos = 0;
+		Target = distance;
+		Done = false;
+	}
+	
+	
+/**************************************************************************************
+ * Set Target
+ **************************************************************************************/
+/** @brief  Move the end of the current move
+ * 	@param   target The new end, measured from where the move started
+ */
+	
+	void ProfileClass::SetTarget(Q16 target)
+	{
+		Target = target;
+		Done = false;
+	}
+	
+	
+/**************************************************************************************
+ * Reset
+ **************************************************************************************/
+/** @brief  Stop dead and forget the move
+ */
+	
+	void ProfileClass::Reset(void)
+	{
+		Target = 0;
+		Pos = 0;
+		Vel = 0;
+		Accel = 0;
+		Done = true;
+	}
+	
+	
+/**************************************************************************************
+ * Brake Speed
+ **************************************************************************************/
+/** @brief  Fastest speed that can still stop in a distance
+ *  @details Stopping from speed v, ramping the accel to the limit A and back
+ *			 at jerk J, takes v^2 / 2A + v A / 2J. Solving that for v:
+ *			 v = sqrt(A^4 / 4J^2 + 2 A d) - A^2 / 2J. For short distances this
+ *			 is a little slow, since the accel never reaches A, which only
+ *			 makes the end of a move gentler. The square root is done on the
+ *			 speed in 1/16 units/s.
+ * 	@param   distance How far there is to stop in, not negative
+ * 	@return  The speed, Q16 units/s
+ */
+	
+	Q16 ProfileClass::BrakeSpeed(Q16 distance)
+	{
+		//A^2 / 2J in units/s, Q16
+		Q16 lag = (Q16) ((((S64) Lim.accel * Lim.accel) / Lim.jerk) / 2);
+		
+		//(lag^2 + 2 A d), in (units/s)^2 with 8 fraction bits
+		S64 square = (((S64) lag * lag) >> 24) + (((S64) 2 * Lim.accel * distance) >> 24);
+		
+		if (square > 0xFFFFFFFFLL) {square = 0xFFFFFFFFLL;}
+		
+		return (Q16) (Isqrt((U32) square) << (Q16_SHIFT - 4)) - lag;
+	}
+	
+	
+/**************************************************************************************
+ * Step
+ **************************************************************************************/
+/** @brief  Move the profile on
+ * 	@param   dt ms since the last step
+ * 	@return  True once it is at the target and stopped
+ */
+	
+	bool ProfileClass::Step(U32 dt)
+	{
+		Q16 toGo = Target - Pos;
+		Q16 rampTime;
+		Q16 rampVel;
+		Q16 wanted;
+		Q16 goal;
+		Q16 maxChange;
+		Q16 oldVel = Vel;
+		
+		if (Done) {return true;}
+		
+		//Where it will be, and how fast, once the accel is ramped back to zero:
+		//t = |a| / J, v + a t / 2 and v t + a t^2 / 3 further on
+		rampTime = (Q16) (((S64) (Accel < 0 ? -Accel : Accel) << Q16_SHIFT) / Lim.jerk);
+		rampVel = Vel + Q16mul(Accel, rampTime) / 2;
+		toGo -= Q16mul(Vel, rampTime) + Q16mul(Q16mul(Accel, rampTime), rampTime) / 3;
+		
+		//Fastest it can go from there and still stop in time, in the right direction
+		wanted = (toGo >= 0) ? BrakeSpeed(toGo) : -BrakeSpeed(-toGo);
+		
+		if (wanted > Lim.vel) {wanted = Lim.vel;}
+		if (wanted < -Lim.vel) {wanted = -Lim.vel;}
+		
+		//Accel towards it in proportion, full accel for a big difference, so it
+		//settles instead of swinging between full accel and full decel
+		goal = (Q16) ((S64) (wanted - rampVel) * Lim.jerk * ACCEL_GAIN / Lim.accel);
+		
+		if (goal > Lim.accel) {goal = Lim.accel;}
+		if (goal < -Lim.accel) {goal = -Lim.accel;}
+		
+		//Move the accel towards the goal, no faster than the jerk allows
+		maxChange = (Q16) ((S64) Lim.jerk * dt / 1000);
+		
+		if (goal > Accel + maxChange) {Accel += maxChange;}
+		else if (goal < Accel - maxChange) {Accel -= maxChange;}
+		else {Accel = goal;}
+		
+		Vel += (Q16) ((S64) Accel * dt / 1000);
+		
+		if (Vel > Lim.vel) {Vel = Lim.vel;}
+		if (Vel < -Lim.vel) {Vel = -Lim.vel;}
+		
+		Pos += (Q16) (((S64) oldVel + Vel) * dt / 2000);
+		
+		//Close enough, settle on the target
+		toGo = Target - Pos;
+		
+		if (toGo < DONE_POS && toGo > -DONE_POS && Vel < DONE_VEL && Vel > -DONE_VEL)
+		{
+			Pos = Target;
+			Vel = 0;
+			Accel = 0;
+			Done = true;
+		}
+		
+		return Done;
+	}
+	
+	
+/**************************************************************************************
+ * Getters
+ **************************************************************************************/
+/** @brief  Position, Q16 units from the start of the move
+ */
+	
+	Q16 ProfileClass::GetPos(void)
+	{
+		return Pos;
+	}
+	
+/** @brief  Speed, Q16 units/s
+ */
+	
+	Q16 ProfileClass::GetVel(void)
+	{
+		return Vel;
+	}
+	
+/** @brief  Accel, Q16 units/s^2
+ */
+	
+	Q16 ProfileClass::GetAccel(void)
+	{
+		return Accel;
+	}
+	
+/** @brief  True once the move is at the target and stopped
+ */
+	
+	bool ProfileClass::IsDone(void)
+	{
+		return Done;
+	}
@@ -0,0 +1,119 @@
+//*************************************************************************************
+/** @file    ProfileClass.hpp
+ *  @brief   Jerk limited motion profiles for drive moves
+ *  @details Instead of setting a power and cutting it to zero at the end, a move
+ * 			 follows a position and speed that ramp up and down smoothly, so the
+ * 			 wheels don't slip at the start and the robot doesn't overshoot at
+ * 			 the end.
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *	  \li 10-18-2026 ARB Accel follows the wanted speed in proportion, so a moved target settles
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _PROFILECLASS_H_
+#define _PROFILECLASS_H_
+
+#include "../lib/FixedPoint.hpp"
+
+/**************************************************************************************
+ * Profile Class Header
+ **************************************************************************************/
+/** @brief  Makes an S-curve (jerk limited) profile to a target, one step at a time.
+ *  @details The profile is worked out as it goes rather than planned up front,
+ *			 so the target can be moved part way through a move (when a sensor
+ *			 says where the wall really is, say) and the profile just bends to
+ *			 suit. Each step it:
+ *			 \li Looks ahead to where it will be, and how fast it will be
+ *				 going, once the accel is ramped back to zero
+ *			 \li Finds the fastest speed it could be going there and still stop
+ *				 at the target with the accel and jerk limits, and caps it at
+ *				 the speed limit
+ *			 \li Asks for accel in proportion to how far off that speed it will
+ *				 be, up to the accel limit. Going straight to full accel or
+ *				 decel would swing back and forth around the target, since the
+ *				 jerk limit stops the accel changing in time.
+ *			 \li Moves the accel towards that by at most the jerk limit, then
+ *				 moves the speed and position on
+ *
+ *			 The units are up to the user, mm for a drive or degrees for a turn.
+ *			 Everything is Q16: position in units, speed in units/s, accel in
+ *			 units/s^2 and jerk in units/s^3. Speeds up to 4096 units/s work.
+ */
+
+
+class ProfileClass
+{
+
+public:
+
+	//How hard a move may be
+	struct Limits
+	{
+		Q16 vel;       /**<Top speed, units/s*/
+		Q16 accel;     /**<Most accel, units/s^2*/
+		Q16 jerk;      /**<Most change of accel, units/s^3*/
+	};
+
+	//Constructor
+	ProfileClass(const Limits& limits);
+	
+	//Change the limits, takes effect on the next step
+	void SetLimits(const Limits& limits);
+	
+	//Start a move of some distance from here, keeping the current speed and accel
+	void Start(Q16 distance);
+	
+	//Move the end of the current move, measured from where it started
+	void SetTarget(Q16 target);
+	
+	//Stop dead and forget the move
+	void Reset(void);
+	
+	//Move the profile on by some ms, true once it is at the target and stopped
+	bool Step(U32 dt);
+	
+	//Where the profile is
+	Q16 GetPos(void);
+	Q16 GetVel(void);
+	Q16 GetAccel(void);
+	bool IsDone(void);
+	
+protected:
+
+	//Fastest speed that can still stop in a distance
+	Q16 BrakeSpeed(Q16 distance);
+	
+	Limits Lim;
+	
+	Q16 Target;
+	Q16 Pos;
+	Q16 Vel;
+	Q16 Accel;
+	bool Done;
+
+};
+
+
+//Fixes weird linker issues....
+#include "ProfileClass.cpp"
+
+#endif
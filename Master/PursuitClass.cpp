@@ -0,0 +1,290 @@
+//*************************************************************************************
+/** @file    PursuitClass.cpp
+ *  @brief   Cpp file for the pursuit class
+ *  @details Goal point search and steering for the path follower.
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *	  \li 10-18-2026 ARB Added GetSpeedLimit()
+ *	  \li 10-18-2026 ARB Turns no sharper than a pivot, and turns around for a goal behind
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+//Need header file for the class
+#include "PursuitClass.hpp"
+
+/**************************************************************************************
+ * Constants
+ **************************************************************************************/
+
+//Look-ahead when stopped, Q16 mm
+#define LOOK_MIN      INT2Q16(80)
+
+//Look-ahead added per mm/s of speed, Q16 s
+#define LOOK_TIME     FLOAT2Q16(0.4)
+
+//Closer than this to the last waypoint, along the path, is there. Q16 mm.
+#define ARRIVE_DIST   INT2Q16(3)
+
+
+/**************************************************************************************
+ * Constructor
+ **************************************************************************************/
+/** @brief  Class constructor
+ * 	@param   p_Bot Robot whose pose is followed
+ */
+
+	PursuitClass::PursuitClass(RobotClass* p_Bot)
+	{
+		this -> p_Bot = p_Bot;
+		
+		p_Path = 0;
+		Count = 0;
+		Origin.x = 0;
+		Origin.y = 0;
+		Origin.speed = 0;
+		Current = 0;
+		Remaining = 0;
+	}
+	
+	
+/**************************************************************************************
+ * Start
+ **************************************************************************************/
+/** @brief  Follow a path from where the robot is now
+ * 	@param   p_Path The waypoints, which must stay put until the path is done
+ * 	@param   count  Number of waypoints
+ */
+	
+	void PursuitClass::Start(const Point* p_Path, U8 count)
+	{
+		RobotClass::RectData pos = p_Bot -> GetInfo();
+		
+		this -> p_Path = p_Path;
+		Count = count;
+		Origin.x = pos.x;
+		Origin.y = pos.y;
+		Current = 0;
+		
+		Remaining = 0;
+		for (U8 n = 0; n < Count; n++)
+		{
+			Remaining += INT2Q16(SegmentLength(n));
+		}
+	}
+	
+	
+/**************************************************************************************
+ * Steer
+ **************************************************************************************/
+/** @brief  Wheel speeds to follow the path
+ *  @details Call once per nav cycle, after @c RobotClass::Update().
+ * 	@param   speed How fast to go along the path, Q16 mm/s
+ * 	@param   left  Where the left wheel speed is written, Q16 mm/s
+ * 	@param   right Where the right wheel speed is written, Q16 mm/s
+ * 	@return  True once the robot is at the last waypoint. Both speeds are then
+ *			 zero.
+ */
+	
+	bool PursuitClass::Steer(Q16 speed, Q16& left, Q16& right)
+	{
+		RobotClass::RectData pos = p_Bot -> GetInfo();
+		Q16 look = LOOK_MIN + Q16mul(LOOK_TIME, (speed < 0) ? -speed : speed);
+		S32 lookMm = Q16round(look);
+		Point from;
+		Point to;
+		S32 len = 0;
+		Q16 ux = 0;
+		Q16 uy = 0;
+		Q16 along = 0;
+		S32 cross;
+		Q16 goal = 0;
+		S32 dx;
+		S32 dy;
+		Q16 gx;
+		Q16 gy;
+		Q16 lx;
+		Q16 ly;
+		S32 dist2;
+		S64 turn;
+		Q16 rad;
+		Q16 base;
+		Q16 delta;
+		Q16 limit;
+		
+		left = 0;
+		right = 0;
+		
+		if (Count == 0) {return true;}
+		
+		//Find the goal point, moving on a segment once it is past the end
+		while (true)
+		{
+			from = GetPoint(Current);
+			to = GetPoint(Current + 1);
+			len = SegmentLength(Current);
+			
+			if (len > 0)
+			{
+				ux = (to.x - from.x) / len;
+				uy = (to.y - from.y) / len;
+				
+				//Where the robot is along the segment, and how far off to the side
+				along = Q16mul(pos.x - from.x, ux) + Q16mul(pos.y - from.y, uy);
+				cross = Q16round(Q16mul(pos.y - from.y, ux) - Q16mul(pos.x - from.x, uy));
+				
+				//Half the chord the look-ahead circle cuts from the segment's line
+				goal = along;
+				if (cross < lookMm && cross > -lookMm)
+				{
+					goal += INT2Q16(Isqrt((U32) (lookMm * lookMm - cross * cross)));
+				}
+			}
+			
+			if (Current + 1 < Count && (len == 0 || goal > INT2Q16(len)))
+			{
+				Current++;
+				continue;
+			}
+			
+			break;
+		}
+		
+		//Distance still to go, along this segment and the ones after it. The goal
+		//moves on to a segment before the robot reaches it, so until then the
+		//corner is still to get to.
+		if (along < 0)
+		{
+			dx = Q16round(from.x - pos.x);
+			dy = Q16round(from.y - pos.y);
+			Remaining = INT2Q16(Isqrt((U32) (dx * dx + dy * dy)) + len);
+		}
+		else
+		{
+			Remaining = INT2Q16(len) - along;
+		}
+		
+		for (U8 n = Current + 1; n < Count; n++)
+		{
+			Remaining += INT2Q16(SegmentLength(n));
+		}
+		
+		if (Current + 1 == Count && Remaining <= ARRIVE_DIST)
+		{
+			Remaining = 0;
+			return true;
+		}
+		
+		//Goal point in the robot's frame, x ahead and y to the left
+		gx = from.x + Q16mul(ux, goal) - pos.x;
+		gy = from.y + Q16mul(uy, goal) - pos.y;
+		
+		lx = Q16mul(gx, CosQ16(pos.theta)) + Q16mul(gy, SinQ16(pos.theta));
+		ly = Q16mul(gy, CosQ16(pos.theta)) - Q16mul(gx, SinQ16(pos.theta));
+		
+		dist2 = Q16round(lx) * Q16round(lx) + Q16round(ly) * Q16round(ly);
+		if (dist2 < 1) {dist2 = 1;}
+		
+		//Each wheel is off the speed by v * curvature * base / 2 = v y base / L^2
+		p_Bot -> GetGeometry(rad, base);
+		
+		turn = (S64) speed * ly / dist2;
+		delta = (Q16) ((turn * base) >> 32);
+		
+		//No sharper than pivoting on the inside wheel. A goal beside or behind
+		//the robot gets that turn towards its side, left if it is dead behind,
+		//since the arc to it would be too gentle or lead straight away from it.
+		limit = (speed < 0) ? -speed : speed;
+		
+		if (lx <= 0)
+		{
+			delta = (ly < 0) ? -speed : speed;
+		}
+		else if (delta > limit)
+		{
+			delta = limit;
+		}
+		else if (delta < -limit)
+		{
+			delta = -limit;
+		}
+		
+		left = speed - delta;
+		right = speed + delta;
+		
+		return false;
+	}
+	
+	
+/**************************************************************************************
+ * Get Point
+ **************************************************************************************/
+/** @brief  One end of a segment
+ * 	@param   n 0 for where the path started, then each waypoint in turn
+ */
+	
+	PursuitClass::Point PursuitClass::GetPoint(U8 n)
+	{
+		return (n == 0) ? Origin : p_Path[n - 1];
+	}
+	
+	
+/**************************************************************************************
+ * Segment Length
+ **************************************************************************************/
+/** @brief  Length of a segment in whole mm
+ * 	@param   n Segment, 0 is from the start to the first waypoint
+ */
+	
+	S32 PursuitClass::SegmentLength(U8 n)
+	{
+		S32 dx = Q16round(GetPoint(n + 1).x - GetPoint(n).x);
+		S32 dy = Q16round(GetPoint(n + 1).y - GetPoint(n).y);
+		
+		return (S32) Isqrt((U32) (dx * dx + dy * dy));
+	}
+	
+	
+/**************************************************************************************
+ * Getters
+ **************************************************************************************/
+/** @brief  Distance along the path to the last waypoint, Q16 mm
+ */
+	
+	Q16 PursuitClass::GetRemaining(void)
+	{
+		return Remaining;
+	}
+	
+/** @brief  Segment being followed, 0 is from the start to the first waypoint
+ */
+	
+	U8 PursuitClass::GetSegment(void)
+	{
+		return Current;
+	}
+	
+/** @brief  Top speed on the segment being followed, mm/s. 0 for no limit, or if
+ *			there is no path.
+ */
+	
+	S16 PursuitClass::GetSpeedLimit(void)
+	{
+		return (Count == 0) ? 0 : p_Path[Current].speed;
+	}
@@ -0,0 +1,124 @@
+//*************************************************************************************
+/** @file    PursuitClass.hpp
+ *  @brief   Pure pursuit path follower for open field moves
+ *  @details Drives through a list of waypoints in one smooth curve, instead of
+ * 			 stopping to turn at each one.
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *	  \li 10-18-2026 ARB Waypoints carry a speed limit for the segment to them
+ *	  \li 10-18-2026 ARB Turns no sharper than a pivot, and turns around for a goal behind
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _PURSUITCLASS_H_
+#define _PURSUITCLASS_H_
+
+#include "RobotClass.hpp"
+
+/**************************************************************************************
+ * Pursuit Class Header
+ **************************************************************************************/
+/** @brief  Steers along a path of straight segments with pure pursuit.
+ *  @details The path runs from where the robot is when @c Start() is called,
+ *			 through each waypoint in turn. Each call to @c Steer():
+ *			 \li Finds the goal point, where a circle of the look-ahead distance
+ *				 around the robot crosses the path ahead of it. Once the goal
+ *				 would be past the end of a segment, it moves on to the next.
+ *			 \li Works out the arc from the robot to the goal point that leaves
+ *				 along the robot's heading: curvature 2 y / L^2, with the goal y
+ *				 to the left and L away.
+ *			 \li Splits the speed between the wheels to drive that arc, no
+ *				 sharper than pivoting on the inside wheel. A goal beside or
+ *				 behind the robot gets the pivot towards its side.
+ *
+ *			 The look-ahead grows with speed, so the robot cuts corners a
+ *			 little more when it is going fast rather than weaving. The last
+ *			 segment carries on past the last waypoint for the goal point, so
+ *			 the robot comes in straight along it instead of hunting for the
+ *			 point as it gets close.
+ *
+ *			 Each waypoint has a top speed for the segment leading to it, which
+ *			 @c GetSpeedLimit() gives for the segment being followed. Segments
+ *			 are taken on by the goal point, so the limit changes about a
+ *			 look-ahead before the robot gets to the segment.
+ *
+ *			 Positions are Q16 mm in the same frame as @c RobotClass. The square
+ *			 roots are done in whole mm, which is plenty for steering.
+ */
+
+
+class PursuitClass
+{
+
+public:
+
+	//A waypoint
+	struct Point
+	{
+		Q16 x;         /**<mm*/
+		Q16 y;         /**<mm*/
+		S16 speed;     /**<Top speed on the segment to this waypoint, mm/s, 0 for no limit*/
+	};
+
+	//Constructor
+	PursuitClass(RobotClass* p_Bot);
+	
+	//Follow a path from where the robot is now. The path is not copied.
+	void Start(const Point* p_Path, U8 count);
+	
+	//Wheel speeds to follow the path at a speed, true once at the last waypoint
+	bool Steer(Q16 speed, Q16& left, Q16& right);
+	
+	//Distance along the path to the last waypoint, as of the last Steer()
+	Q16 GetRemaining(void);
+	
+	//Segment being followed, 0 is from the start to the first waypoint
+	U8 GetSegment(void);
+	
+	//Top speed on the segment being followed, mm/s, 0 for no limit
+	S16 GetSpeedLimit(void);
+	
+protected:
+
+	//One end of a segment, 0 is where the path started
+	Point GetPoint(U8 n);
+	
+	//Length of a segment in whole mm
+	S32 SegmentLength(U8 n);
+	
+	//Robot whose pose is followed
+	RobotClass* p_Bot;
+	
+	//The path
+	const Point* p_Path;
+	U8 Count;
+	Point Origin;
+	
+	U8 Current;
+	Q16 Remaining;
+
+};
+
+
+//Fixes weird linker issues....
+#include "PursuitClass.cpp"
+
+#endif
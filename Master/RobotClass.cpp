@@ -6,6 +6,15 @@
  *
  *  Revised:    
  *	  \li 03-10-2015 ARB Original file
+ *	  \li 10-18-2026 ARB Rebuilt on fixed point numbers and table based trig
+ *	  \li 10-18-2026 ARB Encoders are sampled from the 1 ms interrupt
+ *	  \li 10-18-2026 ARB Exact arc integration of each step
+ *	  \li 10-18-2026 ARB Added the pose history
+ *	  \li 10-18-2026 ARB Filtered wheel speeds
+ *	  \li 10-18-2026 ARB Added Correct() for landmark fixes
+ *	  \li 10-18-2026 ARB Added GetGeometry() and GetTurnTicks() for calibration
+ *	  \li 10-18-2026 ARB Builds on a PC with HOST_BUILD
+ *	  \li 10-18-2026 ARB Long steps are split so the heading can't wrap
  *
  *  License:
  *	 		
@@ -28,11 +37,40 @@
 //Need header file for the class
 #include "RobotClass.hpp"
 
-//Needed for timer function
+//Needed for timer function, HostOS.hpp has it on a PC
+#ifndef HOST_BUILD
 #include "../../nxtOSEK/NXtpandedLib/src/NNxt.hpp"
+#endif
 
-//Need for the sin and cos functions
-#include "../../yagarto-old/arm-none-eabi/include/c++/4.6.2/cmath"
+//Needed for the cycle counter
+#include "../lib/ExtraFunctions.hpp"
+
+//Half turn angles (in rad, Q16) below which sinc is worked out from its series
+#define SINC_SERIES_LIMIT 16384 //0.25 rad
+
+//Most one arc may turn, as a binary angle (a quarter turn), and the most arcs
+//one step is split into
+#define MAX_ARC_TURN   (1LL << 30)
+#define MAX_ARC_PIECES 32
+
+//ms between poses kept in the history. With HISTORY_SIZE this covers 256 ms.
+#define HISTORY_PERIOD 4
+
+//Wheel speed filter gains, Q16. Critically damped: beta = alpha^2 / (2 - alpha).
+#define VEL_ALPHA 6554 //0.1
+#define VEL_BETA 345   //0.00526
+
+//Gap between samples (ms) after which the speed filter starts over
+#define VEL_RESTART 50
+
+//Speed below which the time between ticks is used instead, Q16 ticks/s
+#define VEL_LOW_SPEED 6553600 //100 ticks/s
+
+//Time without a tick (ms) after which a wheel is taken to be stopped
+#define VEL_STOP_TIME 250
+
+//Keeps the compiler from moving memory accesses across the sample buffer indexes
+#define COMPILER_BARRIER() __asm__ __volatile__ ("" ::: "memory")
 
 
 /**************************************************************************************
@@ -50,27 +88,19 @@
 		p_Lmotor = p_LeftMotor;
 		p_Rmotor = p_RightMotor;
 		
-		//Clear Rect data
-		BotData.x = 0;
-		BotData.y = 0;
-		BotData.xdot = 0;
-		BotData.ydot = 0;
-		BotData.theta = 0;
-		BotData.thetadot = 0;
+		SetGeometry(WHEEL_RAD, WHEEL_BASE);
 		
-		//Clear old  Rect data
-		BotDataOld = BotData;
-	
-		//Clear local data (left)
-		lData.vel = 0;
-		lData.pos_old = 0;
-		lData.pos_new = 0;
+		UpdateCycles = 0;
+		MaxUpdateCycles = 0;
 		
-		//Clear local data (right)
-		rData = lData;
+		SampleHead = 0;
+		SampleTail = 0;
+		SampleOverruns = 0;
 		
-		NewTime = NNxt::getTick();
-		OldTime = NewTime;
+		CorrectionX = 0;
+		CorrectionY = 0;
+		
+		Reset();
 	}
 	
 	
@@ -92,7 +122,9 @@
 * Reset Data
 **************************************************************************************/
 /** @brief  Resets Robot object data
-*  	@details Stets all values to 0 to reset the object
+*  	@details Stets all values to 0 to reset the object. The encoders are read
+*			 so that only motion after the reset counts, and samples still
+*			 waiting in the buffer are thrown away.
 */
 	
 	void RobotClass::Reset (void)
@@ -105,62 +137,534 @@
 		BotData.theta = 0;
 		BotData.thetadot = 0;
 		
-		//Clear old  Rect data
-		BotDataOld = BotData;
-	
-		//Clear local data (left)
-		lData.vel = 0;
-		lData.pos_old = 0;
-		lData.pos_new = 0;
+		//Start counting from where the wheels are now
+		lCountOld = p_Lmotor -> getCount();
+		rCountOld = p_Rmotor -> getCount();
+		
+		OldTime = NNxt::getTick();
 		
-		//Clear local data (right)
-		rData = lData;
+		//Wheels start out stopped
+		LeftTrack.err = 0;
+		LeftTrack.vel = 0;
+		LeftTrack.edgeVel = 0;
+		LeftTrack.edgeTick = OldTime;
+		RightTrack = LeftTrack;
 		
-		NewTime = NNxt::getTick();
-		OldTime = NewTime;
+		//Only the reader moves the tail, so this is safe while sampling
+		SampleTail = SampleHead;
+		
+		//Old poses don't mean anything after a reset
+		HistoryHead = 0;
+		HistoryCount = 0;
+		Remember(OldTime);
 	}	
 	
 	
+/**************************************************************************************
+* Set Geometry
+**************************************************************************************/
+/** @brief  Change the wheel size and spacing
+*  	@details Works out the distance per encoder tick and the heading change per
+*			 tick of difference between the wheels, so @c Update() only has to
+*			 multiply.
+*	@param   wheelRad  Radius of the drive wheels, Q16 mm
+*	@param   wheelBase Distance between the drive wheels, Q16 mm
+*/
+	
+	void RobotClass::SetGeometry(Q16 wheelRad, Q16 wheelBase)
+	{
+		WheelRad = wheelRad;
+		WheelBase = wheelBase;
+		
+		//One tick is a degree of wheel rotation: 2 pi r / 360, kept with 24 fraction bits
+		MmPerTick = (S32) (((S64) WheelRad * Q16_TWO_PI / 360 + (1 << 7)) >> 8);
+		
+		//Heading change is (2 pi r / 360) / base radians, which is r / base / 360 of a turn
+		BamPerTick = (S32) ((((S64) WheelRad << 32) / WheelBase + 180) / 360);
+	}
+	
+	
+/**************************************************************************************
+* Get Geometry
+**************************************************************************************/
+/** @brief  Read back the wheel size and spacing in use
+*	@param   wheelRad  Where the radius of the drive wheels is written, Q16 mm
+*	@param   wheelBase Where the distance between the drive wheels is written, Q16 mm
+*/
+	
+	void RobotClass::GetGeometry(Q16& wheelRad, Q16& wheelBase)
+	{
+		wheelRad = WheelRad;
+		wheelBase = WheelBase;
+	}
+	
+	
+/**************************************************************************************
+* Get Turn Ticks
+**************************************************************************************/
+/** @brief  Encoder ticks each wheel turns for the robot to spin once in place
+*  	@details Each wheel rolls pi * base, and a tick is 2 pi r / 360 of that,
+*			 so it is 180 * base / r.
+*/
+	
+	S32 RobotClass::GetTurnTicks(void)
+	{
+		return (S32) (((S64) WheelBase * 180 + WheelRad / 2) / WheelRad);
+	}
+	
+	
+/**************************************************************************************
+*  Sample
+**************************************************************************************/
+/** @brief  Read both encoders into the sample buffer
+* 	@details Call this from the 1 ms interrupt. Both counts and the time go
+*			 into the head slot, then the head is moved on, so @c Update()
+*			 never sees a half written sample. If the buffer is full the
+*			 sample is dropped and counted; since the counts are absolute no
+*			 distance is lost, only time resolution.
+*/
+	
+	void RobotClass::Sample(void)
+	{
+		U8 next = SampleHead + 1;
+		
+		if (next >= SAMPLE_BUFFER_SIZE) {next = 0;}
+		
+		if (next == SampleTail)
+		{
+			SampleOverruns++;
+			return;
+		}
+		
+		Samples[SampleHead].lCount = p_Lmotor -> getCount();
+		Samples[SampleHead].rCount = p_Rmotor -> getCount();
+		Samples[SampleHead].tick = NNxt::getTick();
+		
+		COMPILER_BARRIER();
+		SampleHead = next;
+	}
+	
+	
+/**************************************************************************************
+*  Integrate
+**************************************************************************************/
+/** @brief  Move the pose along by one pair of encoder steps
+* 	@details A step is normally one ms and turns a fraction of a degree, but
+*			 after a long gap between samples it can turn further than the
+*			 binary angle holds, which would wrap the heading. So a step that
+*			 turns more than @c MAX_ARC_TURN is split into equal arcs that
+*			 don't. More than @c MAX_ARC_PIECES arcs (8 turns in one step) can
+*			 only be a bad reading, and its turn is held to that.
+*	@param   dl     Ticks the left wheel turned
+*	@param   dr     Ticks the right wheel turned
+*	@param   ds     Returns the distance the middle of the robot moved, Q16 mm
+*	@param   dTheta Returns the heading change, as a binary angle
+*/
+	
+	void RobotClass::Integrate(S32 dl, S32 dr, Q16& ds, S32& dTheta)
+	{
+		S64 turn = (S64) (dr - dl) * BamPerTick;
+		S64 limit = MAX_ARC_TURN * MAX_ARC_PIECES;
+		S32 pieces;
+		Q16 pieceDs;
+		S32 pieceTheta;
+		
+		if (turn <= MAX_ARC_TURN && turn >= -MAX_ARC_TURN)
+		{
+			Arc(dl, dr, ds, dTheta);
+			return;
+		}
+		
+		//Keep the distance, but turn no further than the arcs can take
+		if (turn > limit || turn < -limit)
+		{
+			S32 sum = dl + dr;
+			S32 diff = (S32) (limit / BamPerTick);
+			
+			if (turn < 0) {diff = -diff;}
+			
+			dl = (sum - diff) / 2;
+			dr = sum - dl;
+			turn = (S64) (dr - dl) * BamPerTick;
+		}
+		
+		pieces = (S32) (((turn < 0) ? -turn : turn) / MAX_ARC_TURN) + 1;
+		ds = 0;
+		dTheta = 0;
+		
+		//Whole ticks for each arc, which add up to the step
+		for (S32 n = 0; n < pieces; n++)
+		{
+			Arc((S32) ((S64) dl * (n + 1) / pieces - (S64) dl * n / pieces),
+				(S32) ((S64) dr * (n + 1) / pieces - (S64) dr * n / pieces), pieceDs, pieceTheta);
+			
+			ds += pieceDs;
+			dTheta = (S32) ((U32) dTheta + (U32) pieceTheta);
+		}
+	}
+	
+	
+/**************************************************************************************
+*  Arc
+**************************************************************************************/
+/** @brief  Move the pose along one arc
+* 	@details With constant wheel speeds over a step the robot drives along a
+*			 circular arc. The straight line from the start to the end of the
+*			 arc points along the midpoint heading, and is shorter than the arc
+*			 by sinc(dTheta / 2) = sin(dTheta / 2) / (dTheta / 2). So the step is
+*			 exact for any turn, not only for small ones. For small turns, and
+*			 the straight line limit where dTheta is 0, sinc comes from the
+*			 first terms of its series so nothing is divided by zero. The turn
+*			 must be no more than @c MAX_ARC_TURN, see @c Integrate().
+*	@param   dl     Ticks the left wheel turned
+*	@param   dr     Ticks the right wheel turned
+*	@param   ds     Returns the distance the middle of the robot moved, Q16 mm
+*	@param   dTheta Returns the heading change, as a binary angle
+*/
+	
+	void RobotClass::Arc(S32 dl, S32 dr, Q16& ds, S32& dTheta)
+	{
+		//Distance the middle of the robot moved and how much it turned
+		ds = (Q16) (((S64) (dl + dr) * MmPerTick) >> (24 - Q16_SHIFT + 1));
+		dTheta = (S32) ((S64) (dr - dl) * BamPerTick);
+		
+		S32 halfTurn = dTheta / 2;
+		U32 midTheta = BotData.theta + (U32) halfTurn;
+		Q16 phi = (Q16) (((S64) halfTurn * Q16_TWO_PI) >> 32);
+		Q16 sinc;
+		Q16 chord;
+		
+		//sinc(phi) = 1 - phi^2 / 6 + phi^4 / 120 - ... is good to 5e-8 below the limit
+		if (phi < SINC_SERIES_LIMIT && phi > -SINC_SERIES_LIMIT)
+		{
+			Q16 phi2 = Q16mul(phi, phi);
+			
+			sinc = Q16_ONE - phi2 / 6 + Q16mul(phi2, phi2) / 120;
+		}
+		else
+		{
+			sinc = Q16div(SinQ16((U32) halfTurn), phi);
+		}
+		
+		chord = Q16mul(ds, sinc);
+		
+		BotData.x += Q16mul(chord, CosQ16(midTheta));
+		BotData.y += Q16mul(chord, SinQ16(midTheta));
+		BotData.theta += (U32) dTheta;
+	}
+	
 	
 /**************************************************************************************
 *  Update Info
 **************************************************************************************/
 /** @brief  Update internal data info. This needs to be called often to be accurate!
-* 	@details This method performs all the calcuations for this object by reading the 
-* 			 encoders for each motor, checking the time that has passed, updating the velocity,
-* 			 and then performing Euler integration to find the positions.
+* 	@details Integrates every sample the interrupt has taken since the last
+*			 update, one step per sample, and runs each sample through the
+*			 wheel speed filters. The velocities are then worked out from the
+*			 filtered wheel speeds. All of it is integer math, the trig comes
+*			 from the table in FixedPoint.hpp.
 */
 	
 	void RobotClass::Update(void)
 	{
-		//Calculate time passed
-		NewTime = NNxt::getTick();
-		deltaTime = NewTime - OldTime;
+		U32 start = cycle_stamp();
+		Q16 ds;
+		S32 dTheta;
+		Q16 left;
+		Q16 right;
+		Q16 speed;
 		
-		//Get encoder counts
-		rData.pos_new = p_Rmotor -> getCount();
-		lData.pos_new = p_Lmotor -> getCount();
+		//Take everything the interrupt has put in so far
+		while (SampleTail != SampleHead)
+		{
+			COMPILER_BARRIER();
+			
+			EncoderSample& sample = Samples[SampleTail];
+			
+			Integrate(sample.lCount - lCountOld, sample.rCount - rCountOld, ds, dTheta);
+			
+			Track(LeftTrack, sample.lCount - lCountOld, sample.tick - OldTime, sample.tick);
+			Track(RightTrack, sample.rCount - rCountOld, sample.tick - OldTime, sample.tick);
+			
+			lCountOld = sample.lCount;
+			rCountOld = sample.rCount;
+			OldTime = sample.tick;
+			
+			if (OldTime - History[(HistoryHead == 0) ? HISTORY_SIZE - 1 : HistoryHead - 1].tick >= HISTORY_PERIOD)
+			{
+				Remember(OldTime);
+			}
+			
+			//Done with the slot, let the interrupt have it back
+			COMPILER_BARRIER();
+			SampleTail = (SampleTail + 1 >= SAMPLE_BUFFER_SIZE) ? 0 : SampleTail + 1;
+		}
 		
-		//Find wheel velocity
-		rData.vel = (rData.pos_new - rData.pos_old) / deltaTime;
-		lData.vel = (lData.pos_new - lData.pos_old) / deltaTime;
+		//Caluclate rates of change from the wheel speeds
+		GetWheelSpeeds(left, right);
+		speed = (left + right) / 2;
 		
-		//Caluclate rates of change
-		BotData.xdot = WHEEL_RAD/2 * (rData.vel + lData.vel) * cos(BotData.theta);
-		BotData.ydot = WHEEL_RAD/2 * (rData.vel + lData.vel) * sin(BotData.theta);
-		BotData.thetadot = WHEEL_RAD/WHEEL_BASE * (rData.vel - lData.vel);
+		BotData.xdot = Q16mul(speed, CosQ16(BotData.theta));
+		BotData.ydot = Q16mul(speed, SinQ16(BotData.theta));
+		BotData.thetadot = Q16div(right - left, WheelBase);
 		
-		//Update current positions
-		BotData.x = BotDataOld.xdot + BotData.xdot * deltaTime;
-		BotData.y = BotDataOld.ydot + BotData.ydot * deltaTime;
-		BotData.theta = BotDataOld.thetadot + BotData.thetadot * deltaTime;
+		UpdateCycles = cycles_since(start);
 		
-		//Update old values
-		OldTime = NewTime;
-		BotDataOld = BotData;
+		if (UpdateCycles > MaxUpdateCycles)
+		{
+			MaxUpdateCycles = UpdateCycles;
+		}
+	}
+	
+	
+/**************************************************************************************
+*  Track
+**************************************************************************************/
+/** @brief  Move one wheel's speed tracking along by one sample
+* 	@details The alpha-beta filter predicts where the wheel should be from its
+*			 speed, then moves its position and speed part way towards the
+*			 count that was read. Its position is kept relative to the last
+*			 count so it stays small however far the robot goes. A gap of more
+*			 than @c VEL_RESTART ms (after a reset or an overrun) starts the
+*			 filter over from the average speed across the gap. Two samples
+*			 with the same time stamp only move the position.
+*
+*			 Alongside it, the time between samples that saw the wheel move
+*			 gives a speed that is good when ticks are sparse. While no tick
+*			 comes, the wheel can't be going faster than one tick over the time
+*			 waited, so that speed is held down to it and drops to zero after
+*			 @c VEL_STOP_TIME ms.
+*	@param   wheel  The wheel's tracking state
+*	@param   dCount Encoder ticks since the last sample
+*	@param   dt     ms since the last sample
+*	@param   tick   Time stamp of this sample
+*/
+	
+	void RobotClass::Track(WheelTrack& wheel, S32 dCount, U32 dt, U32 tick)
+	{
+		U32 period = tick - wheel.edgeTick;
+		Q16 limit;
+		Q16 residual;
+		
+		//Speed from the time between ticks
+		if (dCount != 0)
+		{
+			wheel.edgeVel = (period > 0) ? (Q16) (((S64) dCount << Q16_SHIFT) * 1000 / (S32) period) : 0;
+			wheel.edgeTick = tick;
+		}
+		else if (period > VEL_STOP_TIME)
+		{
+			wheel.edgeVel = 0;
+		}
+		else if (period > 0)
+		{
+			limit = (Q16) (((S64) 1000 << Q16_SHIFT) / (S32) period);
+			
+			if (wheel.edgeVel > limit) {wheel.edgeVel = limit;}
+			if (wheel.edgeVel < -limit) {wheel.edgeVel = -limit;}
+		}
 		
+		//Alpha-beta filter
+		if (dt == 0)
+		{
+			wheel.err -= dCount << Q16_SHIFT;
+			wheel.err -= Q16mul(wheel.err, VEL_ALPHA);
+		}
+		else if (dt > VEL_RESTART)
+		{
+			wheel.vel = (Q16) (((S64) dCount << Q16_SHIFT) * 1000 / (S32) dt);
+			wheel.err = 0;
+		}
+		else
+		{
+			//Predicted position less the new count, the error is minus this
+			residual = wheel.err + (Q16) ((S64) wheel.vel * (S32) dt / 1000) - (dCount << Q16_SHIFT);
+			
+			wheel.vel -= (Q16) ((S64) residual * VEL_BETA * 1000 / (S32) dt >> Q16_SHIFT);
+			wheel.err = residual - Q16mul(residual, VEL_ALPHA);
+		}
 	}
 	
 	
-
- 
\ No newline at end of file
+/**************************************************************************************
+*  Wheel Speed
+**************************************************************************************/
+/** @brief  Best speed estimate for one wheel
+*	@param   wheel The wheel's tracking state
+*	@return  The filter's speed, or the speed from the time between ticks when
+*			 the wheel is going slowly, ticks/s
+*/
+	
+	Q16 RobotClass::WheelSpeed(WheelTrack& wheel)
+	{
+		if (wheel.vel < VEL_LOW_SPEED && wheel.vel > -VEL_LOW_SPEED)
+		{
+			return wheel.edgeVel;
+		}
+		
+		return wheel.vel;
+	}
+	
+	
+/**************************************************************************************
+*  Get Wheel Speeds
+**************************************************************************************/
+/** @brief  Filtered speed of each wheel, as of the last update
+*	@param   left  Where the left wheel's speed is written, Q16 mm/s
+*	@param   right Where the right wheel's speed is written, Q16 mm/s
+*/
+	
+	void RobotClass::GetWheelSpeeds(Q16& left, Q16& right)
+	{
+		left = (Q16) (((S64) WheelSpeed(LeftTrack) * MmPerTick) >> 24);
+		right = (Q16) (((S64) WheelSpeed(RightTrack) * MmPerTick) >> 24);
+	}
+	
+	
+/**************************************************************************************
+*  Remember
+**************************************************************************************/
+/** @brief  Add the current pose to the history, writing over the oldest
+*	@param   tick Time the pose is for
+*/
+	
+	void RobotClass::Remember(U32 tick)
+	{
+		History[HistoryHead].x = BotData.x;
+		History[HistoryHead].y = BotData.y;
+		History[HistoryHead].theta = BotData.theta;
+		History[HistoryHead].tick = tick;
+		
+		HistoryHead = (HistoryHead + 1 >= HISTORY_SIZE) ? 0 : HistoryHead + 1;
+		
+		if (HistoryCount < HISTORY_SIZE) {HistoryCount++;}
+	}
+	
+	
+/**************************************************************************************
+*  Pose At
+**************************************************************************************/
+/** @brief  Find where the robot was at a past time
+* 	@details Searches back from the newest pose in the history for the two that
+*			 are either side of the time, and interpolates between them. A time
+*			 newer than the last update gives the newest pose. Only call this
+*			 from the task that calls @c Update().
+*	@param   tick The time, usually the time stamp of a sensor reading
+*	@param   pose Where the pose is written
+*	@return  False if the time is older than the history, @c pose is then the
+*			 oldest pose there is
+*/
+	
+	bool RobotClass::poseAt(U32 tick, PoseStamp& pose)
+	{
+		U8 newer = (HistoryHead == 0) ? HISTORY_SIZE - 1 : HistoryHead - 1;
+		U8 older;
+		Q16 frac;
+		
+		//Newer than anything integrated yet
+		if ((S32) (tick - History[newer].tick) >= 0)
+		{
+			pose = History[newer];
+			return true;
+		}
+		
+		for (U8 n = 1; n < HistoryCount; n++)
+		{
+			older = (newer == 0) ? HISTORY_SIZE - 1 : newer - 1;
+			
+			if ((S32) (tick - History[older].tick) >= 0)
+			{
+				PoseStamp& a = History[older];
+				PoseStamp& b = History[newer];
+				
+				frac = (Q16) (((S64) (tick - a.tick) << Q16_SHIFT) / (b.tick - a.tick));
+				
+				pose.x = a.x + Q16mul(b.x - a.x, frac);
+				pose.y = a.y + Q16mul(b.y - a.y, frac);
+				pose.theta = a.theta + (U32) (((S64) (S32) (b.theta - a.theta) * frac) >> Q16_SHIFT);
+				pose.tick = tick;
+				
+				return true;
+			}
+			
+			newer = older;
+		}
+		
+		//Older than the history goes back
+		pose = History[newer];
+		return false;
+	}
+	
+	
+/**************************************************************************************
+*  Correct
+**************************************************************************************/
+/** @brief  Move the robot's position by a fix from a landmark
+* 	@details The whole history is moved too, so a @c poseAt() after the fix
+*			 agrees with the new position. Anything that keeps a pose of its
+*			 own has to move it by the same amount, which it can find from the
+*			 change in @c GetCorrection(). Only call this from the task that
+*			 calls @c Update().
+*	@param   dx Change in x, Q16 mm
+*	@param   dy Change in y, Q16 mm
+*/
+	
+	void RobotClass::Correct(Q16 dx, Q16 dy)
+	{
+		BotData.x += dx;
+		BotData.y += dy;
+		
+		for (U8 n = 0; n < HistoryCount; n++)
+		{
+			History[n].x += dx;
+			History[n].y += dy;
+		}
+		
+		CorrectionX += dx;
+		CorrectionY += dy;
+	}
+	
+/** @brief  Sum of every fix made with @c Correct()
+* 	@details It isn't cleared by @c Reset(), so the change between two calls
+*			 is always how far the fixes in between moved the pose.
+*	@param   dx Where the x total is written, Q16 mm
+*	@param   dy Where the y total is written, Q16 mm
+*/
+	
+	void RobotClass::GetCorrection(Q16& dx, Q16& dy)
+	{
+		dx = CorrectionX;
+		dy = CorrectionY;
+	}
+	
+	
+/**************************************************************************************
+*  Update Cost
+**************************************************************************************/
+/** @brief  CPU cycles taken by the last call to @c Update()
+*/
+	
+	U32 RobotClass::GetUpdateCost(void)
+	{
+		return UpdateCycles;
+	}
+	
+/** @brief  CPU cycles taken by the slowest call to @c Update() so far
+*/
+	
+	U32 RobotClass::GetMaxUpdateCost(void)
+	{
+		return MaxUpdateCycles;
+	}
+	
+	
+/**************************************************************************************
+*  Sample Overruns
+**************************************************************************************/
+/** @brief  Samples dropped because @c Update() didn't empty the buffer in time
+*/
+	
+	U32 RobotClass::GetSampleOverruns(void)
+	{
+		return SampleOverruns;
+	}
@@ -7,6 +7,13 @@
  *
  *  Revised:    
  *	  \li 03-09-2015 ARB Original file
+ *	  \li 10-18-2026 ARB Rebuilt on fixed point numbers and table based trig
+ *	  \li 10-18-2026 ARB Encoders are sampled from the 1 ms interrupt
+ *	  \li 10-18-2026 ARB Added the pose history
+ *	  \li 10-18-2026 ARB Filtered wheel speeds
+ *	  \li 10-18-2026 ARB Added Correct() for landmark fixes
+ *	  \li 10-18-2026 ARB Added GetGeometry() and GetTurnTicks() for calibration
+ *	  \li 10-18-2026 ARB Builds on a PC with HOST_BUILD, see OdoReplay.cpp
  *
  *  License:
  *	 		
@@ -31,7 +38,13 @@
 #define _RBTHEADER_H_
 
 
+#ifdef HOST_BUILD
+#include "../lib/MotorSim.hpp"
+#else
 #include <Motor.h>
+#endif
+
+#include "../lib/FixedPoint.hpp"
 
 /**************************************************************************************
  * Robot Class Header
@@ -40,50 +53,60 @@
  *  @details This class will hold position and velocity data of a robot	
  *			 (both liniear and angular). This helps ensure that the robot knows
  *			 where it is at all times.
+ *
+ *			 Everything is done in fixed point so it is cheap enough to run every
+ *			 ms. Distances are Q16 mm, the heading is a binary angle (a full turn
+ *			 is 2^32) and sine and cosine come from a table. The cost of the last
+ *			 update, in CPU cycles, can be read with @c GetUpdateCost().
+ *
+ *			 The encoders are read by @c Sample(), which is called from the 1 ms
+ *			 interrupt so every reading has an exact time stamp. Samples wait in a
+ *			 ring buffer until @c Update() integrates all of them at once, so
+ *			 how often the task gets to run doesn't matter. The interrupt only
+ *			 writes the head of the buffer and the task only writes the tail,
+ *			 so no lock is needed. Don't reset the motor encoders while the
+ *			 robot is being tracked, since every sample is an absolute count.
+ *
+ *			 A short history of time stamped poses is kept as well, so a sensor
+ *			 reading that arrives late can be matched with @c poseAt() to where
+ *			 the robot was when the reading was taken.
+ *
+ *			 The speed of each wheel is tracked sample by sample with an
+ *			 alpha-beta filter, which gives a smooth speed with about 20 ms of
+ *			 lag. Below about 100 ticks/s an encoder tick only comes every few
+ *			 samples, so there the time between ticks is used instead. The
+ *			 velocities in @c BotData come from these wheel speeds.
  */
 
  
 class RobotClass
 {
 
-protected:
-
-	//Pointers to the motor to use for reading encoders
-	ecrobot::Motor* p_Rmotor;
-	ecrobot::Motor* p_Lmotor;
-	
-	//Holds data in a local, motor-specific coordinate frame
-	struct LocalData
-	{
-		S32 vel;
-		S32 pos_new;
-		S32 pos_old;
-	} lData, rData;
-	
-	//Variables to hold timing information
-	U32 OldTime;
-	U32 NewTime;
-	U32 deltaTime;
-	
-	//Constants that hold physical proerties of the robot
-	//to be used in kinematic calculations
-	static const U8 WHEEL_RAD = 0.75; //Inches
-	
-	static const U8 WHEEL_BASE = 4.4; //Inches
-
 public:
 
+	//Physical properties of the robot used in kinematic calculations, in Q16 mm
+	static const Q16 WHEEL_RAD = 1248461;  //0.75 in = 19.05 mm
+	static const Q16 WHEEL_BASE = 7324303; //4.4 in = 111.76 mm
 	
-	//Holds data in a rectangular coordinate system (inches and radians)
+	//Holds data in a rectangular coordinate system
 	struct RectData
 	{
-		S32 x;
-		S32 y;
-		S32 xdot;
-		S32 ydot;
-		S32 theta;
-		S32 thetadot;
-	} BotData, BotDataOld;
+		Q16 x;         /**<Position, mm*/
+		Q16 y;         /**<Position, mm*/
+		Q16 xdot;      /**<Velocity, mm/s*/
+		Q16 ydot;      /**<Velocity, mm/s*/
+		U32 theta;     /**<Heading as a binary angle, a full turn is 2^32*/
+		Q16 thetadot;  /**<Turn rate, rad/s*/
+	} BotData;
+	
+	//Where the robot was at one moment
+	struct PoseStamp
+	{
+		Q16 x;         /**<Position, mm*/
+		Q16 y;         /**<Position, mm*/
+		U32 theta;     /**<Heading as a binary angle*/
+		U32 tick;      /**<System tick, ms*/
+	};
 	
 	//Consructor
 	RobotClass(ecrobot::Motor* p_LeftMotor, ecrobot::Motor* p_RightMotor);
@@ -92,13 +115,116 @@ public:
 	//a rectangular coordinate system
 	inline RectData GetInfo(void);
 	
-	//Update the information in this object.
-	//Needs to be called often as it is not it's own task.
+	//Read both encoders into the sample buffer (1 ms interrupt only)
+	void Sample(void);
+	
+	//Integrate every sample taken since the last update.
+	//Call it often enough that the sample buffer doesn't fill up.
 	void Update(void);
 	
 	//Reset all values to 0
 	void Reset(void);
 	
+	//Find where the robot was at a past time (same task as Update only)
+	bool poseAt(U32 tick, PoseStamp& pose);
+	
+	//Move the robot's position by a fix from a landmark (same task as Update only)
+	void Correct(Q16 dx, Q16 dy);
+	
+	//Sum of every fix so far, Q16 mm
+	void GetCorrection(Q16& dx, Q16& dy);
+	
+	//Change the wheel radius and wheel base, both in Q16 mm
+	void SetGeometry(Q16 wheelRad, Q16 wheelBase);
+	
+	//Current wheel radius and wheel base, both in Q16 mm
+	void GetGeometry(Q16& wheelRad, Q16& wheelBase);
+	
+	//Encoder ticks each wheel turns for the robot to spin once in place
+	S32 GetTurnTicks(void);
+	
+	//CPU cycles taken by the last update and the slowest one
+	U32 GetUpdateCost(void);
+	U32 GetMaxUpdateCost(void);
+	
+	//Samples dropped because the buffer was full
+	U32 GetSampleOverruns(void);
+	
+	//Filtered speed of each wheel, Q16 mm/s
+	void GetWheelSpeeds(Q16& left, Q16& right);
+	
+protected:
+
+	//Pointers to the motor to use for reading encoders
+	ecrobot::Motor* p_Rmotor;
+	ecrobot::Motor* p_Lmotor;
+	
+	//Move the pose along by one pair of encoder steps
+	void Integrate(S32 dl, S32 dr, Q16& ds, S32& dTheta);
+	
+	//Move the pose along one arc of no more than a quarter turn
+	void Arc(S32 dl, S32 dr, Q16& ds, S32& dTheta);
+	
+	//One reading of both encoders, taken in the 1 ms interrupt
+	struct EncoderSample
+	{
+		S32 lCount;
+		S32 rCount;
+		U32 tick;      /**<System tick when it was taken, ms*/
+	};
+	
+	//Samples waiting for Update(). One slot is always left empty.
+	static const U8 SAMPLE_BUFFER_SIZE = 64;
+	EncoderSample Samples[SAMPLE_BUFFER_SIZE];
+	volatile U8 SampleHead;        /**<Next slot Sample() writes, only it changes this*/
+	volatile U8 SampleTail;        /**<Next slot Update() reads, only it changes this*/
+	volatile U32 SampleOverruns;
+	
+	//Speed tracking for one wheel
+	struct WheelTrack
+	{
+		Q16 err;       /**<Filter's position less the last count, ticks*/
+		Q16 vel;       /**<Filter's speed, ticks/s*/
+		Q16 edgeVel;   /**<Speed from the time between ticks, ticks/s*/
+		U32 edgeTick;  /**<Time of the last sample that saw the wheel move, ms*/
+	} LeftTrack, RightTrack;
+	
+	//Move one wheel's speed tracking along by one sample
+	void Track(WheelTrack& wheel, S32 dCount, U32 dt, U32 tick);
+	
+	//Best speed estimate for one wheel, ticks/s
+	Q16 WheelSpeed(WheelTrack& wheel);
+	
+	//Add the current pose to the history
+	void Remember(U32 tick);
+	
+	//Recent poses, oldest first from HistoryHead - HistoryCount
+	static const U8 HISTORY_SIZE = 64;
+	PoseStamp History[HISTORY_SIZE];
+	U8 HistoryHead;                /**<Next slot to write*/
+	U8 HistoryCount;               /**<Slots in use*/
+	
+	//Encoder counts at the last sample integrated
+	S32 lCountOld;
+	S32 rCountOld;
+	
+	//Time stamp of the last sample integrated
+	U32 OldTime;
+	
+	//Sum of every fix from Correct(), Q16 mm
+	Q16 CorrectionX;
+	Q16 CorrectionY;
+	
+	//Geometry, worked out by SetGeometry()
+	Q16 WheelRad;
+	Q16 WheelBase;
+	S32 MmPerTick;   /**<Distance a wheel rolls per encoder tick, mm with 24 fraction bits*/
+	S32 BamPerTick;  /**<Heading change per tick of difference between the wheels*/
+	
+	//Cost of updating, in CPU cycles
+	U32 UpdateCycles;
+	U32 MaxUpdateCycles;
+	
 };
 
 
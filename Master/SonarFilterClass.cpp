@@ -0,0 +1,198 @@
+//*************************************************************************************
+/** @file    SonarFilterClass.cpp
+ *  @brief   Cpp file for the sonar filter class
+ *  @details Rate gate and median of the raw sonar readings.
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+//Need header file for the class
+#include "SonarFilterClass.hpp"
+
+/**************************************************************************************
+ * Constants
+ **************************************************************************************/
+
+//The sonar reads this when it hears no echo
+#define SONAR_NO_ECHO    255
+
+//Fastest the distance to a wall can change, cm/s. Top wheel speed plus some.
+#define SONAR_MAX_RATE   60
+
+//Change allowed on top of the rate, cm, for the whole cm readings
+#define SONAR_RATE_SLACK 3
+
+//Readings dropped in a row by the rate gate before starting over
+#define SONAR_REJECT_LIMIT 3
+
+
+/**************************************************************************************
+ * Constructor
+ **************************************************************************************/
+/** @brief  Class constructor
+ */
+
+	SonarFilterClass::SonarFilterClass(void)
+	{
+		Rejects = 0;
+		
+		Reset();
+	}
+	
+	
+/**************************************************************************************
+ * Reset
+ **************************************************************************************/
+/** @brief  Forget all readings, the next good one comes straight out
+ */
+	
+	void SonarFilterClass::Reset(void)
+	{
+		Count = 0;
+		OutCm = 0;
+		OutTick = 0;
+		LastCm = 0;
+		LastTick = 0;
+		RejectRun = 0;
+	}
+	
+	
+/**************************************************************************************
+ * Add
+ **************************************************************************************/
+/** @brief  Add a raw reading
+ *  @details Until the window is full the newest reading comes out as it is.
+ * 	@param   cm   The reading
+ * 	@param   tick When it was taken
+ * 	@return  True if a filtered reading came out, false if this one was dropped
+ */
+	
+	bool SonarFilterClass::Add(S16 cm, U32 tick)
+	{
+		S32 allowed;
+		S16 change;
+		U8 order[SONAR_MEDIAN];
+		U8 i;
+		U8 j;
+		U8 k;
+		
+		//No echo says nothing about the wall
+		if (cm <= 0 || cm >= SONAR_NO_ECHO)
+		{
+			Rejects++;
+			return false;
+		}
+		
+		//Rate gate against the last good reading
+		if (Count > 0)
+		{
+			allowed = SONAR_MAX_RATE * (S32) (tick - LastTick) / 1000 + SONAR_RATE_SLACK;
+			change = cm - LastCm;
+			
+			if (change > allowed || -change > allowed)
+			{
+				Rejects++;
+				
+				if (++RejectRun < SONAR_REJECT_LIMIT)
+				{
+					return false;
+				}
+				
+				//It has stayed there, so believe it
+				Count = 0;
+			}
+		}
+		
+		RejectRun = 0;
+		LastCm = cm;
+		LastTick = tick;
+		
+		//Slide the window along
+		if (Count == SONAR_MEDIAN)
+		{
+			for (i = 1; i < SONAR_MEDIAN; i++)
+			{
+				WindowCm[i - 1] = WindowCm[i];
+				WindowTick[i - 1] = WindowTick[i];
+			}
+			
+			Count--;
+		}
+		
+		WindowCm[Count] = cm;
+		WindowTick[Count] = tick;
+		Count++;
+		
+		if (Count < SONAR_MEDIAN)
+		{
+			OutCm = cm;
+			OutTick = tick;
+			return true;
+		}
+		
+		//Sort the window by distance, ties stay oldest first
+		for (i = 0; i < SONAR_MEDIAN; i++)
+		{
+			k = i;
+			
+			for (j = i; j > 0 && WindowCm[order[j - 1]] > WindowCm[i]; j--)
+			{
+				order[j] = order[j - 1];
+				k = j - 1;
+			}
+			
+			order[k] = i;
+		}
+		
+		k = order[SONAR_MEDIAN / 2];
+		OutCm = WindowCm[k];
+		OutTick = WindowTick[k];
+		
+		return true;
+	}
+	
+	
+/**************************************************************************************
+ * Getters
+ **************************************************************************************/
+/** @brief  Latest filtered reading, in cm
+ */
+	
+	S16 SonarFilterClass::GetCm(void)
+	{
+		return OutCm;
+	}
+	
+/** @brief  Tick the latest filtered reading was taken at
+ */
+	
+	U32 SonarFilterClass::GetTick(void)
+	{
+		return OutTick;
+	}
+	
+/** @brief  Readings dropped since the start
+ */
+	
+	U16 SonarFilterClass::GetRejects(void)
+	{
+		return Rejects;
+	}
@@ -0,0 +1,103 @@
+//*************************************************************************************
+/** @file    SonarFilterClass.hpp
+ *  @brief   Cleans up raw sonar readings before they are used
+ *  @details The sonar now and then hears a stray echo, or none at all. One bad
+ * 			 reading used to be enough to stop the wall approach early. This
+ * 			 throws those readings out before they get to the wall filter.
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _SONARFILTERCLASS_H_
+#define _SONARFILTERCLASS_H_
+
+#include "../lib/FixedPoint.hpp"
+
+//Number of readings the median is taken over, odd
+#define SONAR_MEDIAN 3
+
+/**************************************************************************************
+ * Sonar Filter Class Header
+ **************************************************************************************/
+/** @brief  Median filter and rate gate for the raw sonar readings.
+ *  @details Each reading goes through three checks:
+ *			 \li No echo (0 or 255 cm) is dropped.
+ *			 \li A reading that moved further from the last good one than the
+ *				 robot could have driven in the time between them is dropped. If
+ *				 several in a row are dropped the sonar must really be seeing
+ *				 something new, so the filter starts over from the reading.
+ *			 \li What is left goes into a window of the last @c SONAR_MEDIAN
+ *				 readings, and the median of the window comes out.
+ *
+ *			 The median comes out with the tick of the reading it came from. On
+ *			 a steady approach the readings are in order, so that is the middle
+ *			 one, and the wall filter brings it up to date with the odometry
+ *			 from then. The median costs some age but no error.
+ */
+
+
+class SonarFilterClass
+{
+
+public:
+
+	//Constructor
+	SonarFilterClass(void);
+	
+	//Forget all readings
+	void Reset(void);
+	
+	//Add a raw reading, true if a filtered one came out
+	bool Add(S16 cm, U32 tick);
+	
+	//Latest filtered reading, in cm, and the tick it was taken at
+	S16 GetCm(void);
+	U32 GetTick(void);
+	
+	//Readings dropped since the start
+	U16 GetRejects(void);
+	
+protected:
+
+	//Window of the latest good readings, oldest first
+	S16 WindowCm[SONAR_MEDIAN];
+	U32 WindowTick[SONAR_MEDIAN];
+	U8 Count;
+	
+	//Latest filtered reading
+	S16 OutCm;
+	U32 OutTick;
+	
+	//Last reading which passed the rate gate
+	S16 LastCm;
+	U32 LastTick;
+	
+	U8 RejectRun;   /**<Readings dropped by the rate gate in a row*/
+	U16 Rejects;
+
+};
+
+
+//Fixes weird linker issues....
+#include "SonarFilterClass.cpp"
+
+#endif
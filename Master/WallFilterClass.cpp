@@ -0,0 +1,250 @@
+//*************************************************************************************
+/** @file    WallFilterClass.cpp
+ *  @brief   Cpp file for the wall filter class
+ *  @details Predict and correct steps of the wall distance filter.
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *	  \li 10-18-2026 ARB Start() won't start from a reading with no echo
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+//Need header file for the class
+#include "WallFilterClass.hpp"
+
+/**************************************************************************************
+ * Constants
+ **************************************************************************************/
+
+//Variance of one sonar reading, mm^2 Q8. Whole cm plus noise, about 15 mm.
+#define SONAR_VAR    57600 //225 mm^2
+
+//Variance added per mm driven, mm^2 Q8. About 10 mm after 100 mm, for wheel slip.
+#define ODO_VAR_PER_MM 256 //1 mm^2
+
+//The sonar reads this when it hears no echo
+#define SONAR_NO_ECHO 255
+
+//Readings further than this many standard deviations out are thrown away, squared
+#define GATE_SIGMA2   9
+
+//Readings thrown away in a row before starting over
+#define REJECT_LIMIT  3
+
+
+/**************************************************************************************
+ * Constructor
+ **************************************************************************************/
+/** @brief  Class constructor
+ * 	@param   p_Bot Robot whose odometry is used
+ */
+
+	WallFilterClass::WallFilterClass(RobotClass* p_Bot)
+	{
+		this -> p_Bot = p_Bot;
+		
+		Distance = 0;
+		Variance = SONAR_VAR;
+		LastX = 0;
+		LastY = 0;
+		p_Bot -> GetCorrection(LastCorrectionX, LastCorrectionY);
+		CosWall = Q16_ONE;
+		SinWall = 0;
+		RejectRun = 0;
+		Rejects = 0;
+	}
+	
+	
+/**************************************************************************************
+ * Start
+ **************************************************************************************/
+/** @brief  Start over from a sonar reading
+ *  @details The wall is taken to be straight ahead of the robot. A reading
+ *			 that @c Measure() would throw away is no place to start from either,
+ *			 so the filter is left as it was.
+ * 	@param   cm   The reading
+ * 	@param   tick When it was taken
+ * 	@return  False if the reading was no good
+ */
+	
+	bool WallFilterClass::Start(S16 cm, U32 tick)
+	{
+		RobotClass::RectData now = p_Bot -> GetInfo();
+		RobotClass::PoseStamp then;
+		
+		//No echo says nothing about the wall
+		if (cm <= 0 || cm >= SONAR_NO_ECHO) {return false;}
+		
+		CosWall = CosQ16(now.theta);
+		SinWall = SinQ16(now.theta);
+		LastX = now.x;
+		LastY = now.y;
+		p_Bot -> GetCorrection(LastCorrectionX, LastCorrectionY);
+		
+		//Bring the reading up to now
+		p_Bot -> poseAt(tick, then);
+		
+		Distance = INT2Q16(cm * 10) - Progress(then.x, then.y, now.x, now.y);
+		Variance = SONAR_VAR;
+		RejectRun = 0;
+		Rejects = 0;
+		
+		return true;
+	}
+	
+	
+/**************************************************************************************
+ * Predict
+ **************************************************************************************/
+/** @brief  Move the estimate by the odometry since the last call
+ *  @details Going backwards moves away from the wall, so the distance grows.
+ *			 Either way the variance grows with the distance driven.
+ */
+	
+	void WallFilterClass::Predict(void)
+	{
+		RobotClass::RectData now = p_Bot -> GetInfo();
+		Q16 moved;
+		
+		Rebase();
+		moved = Progress(LastX, LastY, now.x, now.y);
+		
+		Distance -= moved;
+		Variance += ODO_VAR_PER_MM * Q16round(moved < 0 ? -moved : moved);
+		
+		LastX = now.x;
+		LastY = now.y;
+	}
+	
+	
+/**************************************************************************************
+ * Measure
+ **************************************************************************************/
+/** @brief  Correct the estimate with a sonar reading
+ *  @details The reading is compared with what the estimate says the distance
+ *			 was when it was taken, and the correction is applied to now.
+ * 	@param   cm   The reading
+ * 	@param   tick When it was taken
+ * 	@return  False if it was thrown away
+ */
+	
+	bool WallFilterClass::Measure(S16 cm, U32 tick)
+	{
+		RobotClass::PoseStamp then;
+		Q16 innovation;
+		S32 total;
+		Q16 gain;
+		
+		//No echo says nothing about the wall
+		if (cm <= 0 || cm >= SONAR_NO_ECHO) {return false;}
+		
+		Rebase();
+		p_Bot -> poseAt(tick, then);
+		
+		innovation = INT2Q16(cm * 10) - (Distance + Progress(then.x, then.y, LastX, LastY));
+		total = Variance + SONAR_VAR;
+		
+		//innovation^2 in mm^2 Q8 against the gate
+		if (((S64) innovation * innovation >> 24) > (S64) GATE_SIGMA2 * total)
+		{
+			Rejects++;
+			
+			if (++RejectRun >= REJECT_LIMIT)
+			{
+				return Start(cm, tick);
+			}
+			
+			return false;
+		}
+		
+		RejectRun = 0;
+		
+		gain = (Q16) (((S64) Variance << Q16_SHIFT) / total);
+		
+		Distance += Q16mul(gain, innovation);
+		Variance -= (S32) (((S64) gain * Variance) >> Q16_SHIFT);
+		
+		return true;
+	}
+	
+	
+/**************************************************************************************
+ * Progress
+ **************************************************************************************/
+/** @brief  Distance moved towards the wall between two poses
+ * 	@return  Q16 mm, negative if it moved away
+ */
+	
+	Q16 WallFilterClass::Progress(Q16 fromX, Q16 fromY, Q16 toX, Q16 toY)
+	{
+		return Q16mul(toX - fromX, CosWall) + Q16mul(toY - fromY, SinWall);
+	}
+	
+	
+/**************************************************************************************
+ * Rebase
+ **************************************************************************************/
+/** @brief  Move the last pose by any landmark fixes since it was taken
+ *  @details @c RobotClass::Correct() moves the robot's pose and its history,
+ *			 but not the copy kept here. Without this a fix would look like the
+ *			 robot had driven, and a reading's pose from @c RobotClass::poseAt()
+ *			 would be compared with a pose from before the fix.
+ */
+	
+	void WallFilterClass::Rebase(void)
+	{
+		Q16 dx;
+		Q16 dy;
+		
+		p_Bot -> GetCorrection(dx, dy);
+		
+		LastX += dx - LastCorrectionX;
+		LastY += dy - LastCorrectionY;
+		LastCorrectionX = dx;
+		LastCorrectionY = dy;
+	}
+	
+	
+/**************************************************************************************
+ * Getters
+ **************************************************************************************/
+/** @brief  Estimated distance to the wall, Q16 mm
+ */
+	
+	Q16 WallFilterClass::GetDistance(void)
+	{
+		return Distance;
+	}
+	
+/** @brief  Standard deviation of the estimate, Q16 mm
+ */
+	
+	Q16 WallFilterClass::GetSigma(void)
+	{
+		//The root of a Q8 number is Q4
+		return (Q16) (Isqrt((U32) Variance) << (Q16_SHIFT - 4));
+	}
+	
+/** @brief  Readings thrown away since Start()
+ */
+	
+	U16 WallFilterClass::GetRejects(void)
+	{
+		return Rejects;
+	}
@@ -0,0 +1,121 @@
+//*************************************************************************************
+/** @file    WallFilterClass.hpp
+ *  @brief   Distance to the wall from the sonar and the odometry together
+ *  @details The sonar only gives a new reading every few nav cycles, in whole cm,
+ * 			 and now and then gives a wild one. Between readings the odometry
+ * 			 knows how far the robot has moved, so a Kalman filter can keep a
+ * 			 good distance estimate every cycle.
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *	  \li 10-18-2026 ARB Start() won't start from a reading with no echo
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _WALLFILTERCLASS_H_
+#define _WALLFILTERCLASS_H_
+
+#include "RobotClass.hpp"
+
+/**************************************************************************************
+ * Wall Filter Class Header
+ **************************************************************************************/
+/** @brief  One dimensional Kalman filter for the distance from the sonar to a wall.
+ *  @details The wall is taken to be square to the robot's heading when
+ *			 @c Start() is called. @c Predict() moves the estimate by how far the
+ *			 robot has gone towards the wall since the last call, and grows the
+ *			 variance with the distance driven. @c Measure() corrects it with a
+ *			 sonar reading. The reading is compared with where the robot was when
+ *			 it was taken (from @c RobotClass::poseAt()), so its age doesn't
+ *			 matter. When a landmark fix moves the robot's pose, the pose kept
+ *			 here is moved with it, so the fix isn't taken for driving.
+ *
+ *			 A reading more than three standard deviations from the estimate is
+ *			 thrown away. If several in a row are thrown away the estimate must be
+ *			 the one that is wrong, so the filter starts over from the reading.
+ *
+ *			 Distances are Q16 mm. The variance is kept in mm^2 with 8 fraction
+ *			 bits, which is good to a standard deviation of 2.8 m.
+ */
+
+
+class WallFilterClass
+{
+
+public:
+
+	//Constructor
+	WallFilterClass(RobotClass* p_Bot);
+	
+	//Start over from a sonar reading, in cm
+	bool Start(S16 cm, U32 tick);
+	
+	//Move the estimate by the odometry since the last call (same task as RobotClass::Update)
+	void Predict(void);
+	
+	//Correct the estimate with a sonar reading, false if it was thrown away
+	bool Measure(S16 cm, U32 tick);
+	
+	//Estimated distance to the wall, Q16 mm
+	Q16 GetDistance(void);
+	
+	//Standard deviation of the estimate, Q16 mm
+	Q16 GetSigma(void);
+	
+	//Readings thrown away since Start()
+	U16 GetRejects(void);
+	
+protected:
+
+	//Robot whose odometry is used
+	RobotClass* p_Bot;
+	
+	//Distance towards the wall between two poses, Q16 mm
+	Q16 Progress(Q16 fromX, Q16 fromY, Q16 toX, Q16 toY);
+	
+	//Move the last pose by any landmark fixes since it was taken
+	void Rebase(void);
+	
+	//The estimate
+	Q16 Distance;
+	S32 Variance;   /**<mm^2, 8 fraction bits*/
+	
+	//Pose at the last prediction
+	Q16 LastX;
+	Q16 LastY;
+	
+	//RobotClass::GetCorrection() when LastX and LastY were last moved
+	Q16 LastCorrectionX;
+	Q16 LastCorrectionY;
+	
+	//Direction of the wall, as a unit vector
+	Q16 CosWall;
+	Q16 SinWall;
+	
+	U8 RejectRun;   /**<Readings thrown away in a row*/
+	U16 Rejects;
+
+};
+
+
+//Fixes weird linker issues....
+#include "WallFilterClass.cpp"
+
+#endif
@@ -0,0 +1,309 @@
+//*************************************************************************************
+/** @file    WheelControlClass.cpp
+ *  @brief   Cpp file for the wheel control class
+ *  @details Speed measurement and the PI loop for one wheel.
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *	  \li 10-18-2026 ARB Stops ramp down, then brake and hold the wheel where it is
+ *	  \li 10-18-2026 ARB Speed comes from the odometry's wheel filter
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+//Need header file for the class
+#include "WheelControlClass.hpp"
+
+/**************************************************************************************
+ * Constants
+ **************************************************************************************/
+
+//Power to get a wheel turning at all, at the nominal battery voltage
+#define WHEEL_KS      INT2Q16(15)
+
+//Power per mm/s, at the nominal battery voltage
+#define WHEEL_KV      FLOAT2Q16(0.3)
+
+//Power per mm/s of speed error
+#define WHEEL_KP      FLOAT2Q16(0.2)
+
+//Power per mm of integrated speed error
+#define WHEEL_KI      FLOAT2Q16(2.0)
+
+//Battery voltage the feed forward gains are for, mV
+#define NOMINAL_MV    7800
+
+//Below this the battery reading can't be right, so the feed forward isn't scaled
+#define MIN_MV        4000
+
+//Slower than this counts as stopped when the command is zero, Q16 mm/s
+#define STOP_SPEED    INT2Q16(5)
+
+//Slow down of a stop, Q16 mm/s^2. Harder than the nav profiles, so it only
+//shapes stops they didn't already ramp down.
+#define STOP_DECEL    INT2Q16(1000)
+
+//Ticks a held wheel may be pushed off before it is driven back
+#define HOLD_DEADBAND 2
+
+//Power per tick a held wheel is off by, past the deadband
+#define HOLD_KP       4
+
+//Most power used to hold a wheel
+#define HOLD_MAX      40
+
+
+/**************************************************************************************
+ * Constructor
+ **************************************************************************************/
+/** @brief  Class constructor
+ * 	@param   p_Motor Wheel to control
+ */
+
+	WheelControlClass::WheelControlClass(ecrobot::Motor* p_Motor)
+	{
+		this -> p_Motor = p_Motor;
+		
+		Reset();
+	}
+	
+	
+/**************************************************************************************
+ * Reset
+ **************************************************************************************/
+/** @brief  Forget the integral and any stop
+ *  @details The next @c Run() doesn't integrate, since there is no time since
+ *			 the last one. It also floats the motor for driving.
+ */
+	
+	void WheelControlClass::Reset(void)
+	{
+		LastTick = 0;
+		Started = false;
+		Speed = 0;
+		ErrorSum = 0;
+		Power = 0;
+		Stopping = false;
+		Holding = false;
+		RampSpeed = 0;
+		LogHead = 0;
+		Stops = 0;
+	}
+	
+	
+/**************************************************************************************
+ * Run
+ **************************************************************************************/
+/** @brief  Run the loop once
+ * 	@param   command   Speed to hold, Q16 mm/s
+ * 	@param   speed     Speed the wheel is going, Q16 mm/s
+ * 	@param   mmPerTick Distance the wheel rolls per encoder tick, Q16 mm
+ * 	@param   batteryMV Battery voltage now, mV
+ * 	@param   tick      System time now, ms
+ */
+	
+	void WheelControlClass::Run(Q16 command, Q16 speed, Q16 mmPerTick, U16 batteryMV, U32 tick)
+	{
+		S32 count = p_Motor -> getCount();
+		U32 dt = 0;
+		Q16 feed;
+		Q16 error;
+		Q16 out;
+		Q16 maxChange;
+		S32 power;
+		
+		if (Started)
+		{
+			dt = tick - LastTick;
+		}
+		else
+		{
+			//First call since a reset, the motor may still be in brake mode
+			p_Motor -> setBrake(false);
+			Started = true;
+		}
+		
+		LastTick = tick;
+		Speed = speed;
+		
+		//Nothing asked for: ramp down, then brake and hold
+		if (command == 0)
+		{
+			if (Holding)
+			{
+				Hold(count);
+				return;
+			}
+			
+			if (!Stopping)
+			{
+				Stopping = true;
+				RampSpeed = Speed;
+				StopSpeed = Speed;
+				StopCount = count;
+			}
+			
+			maxChange = (Q16) ((S64) STOP_DECEL * dt / 1000);
+			
+			if (RampSpeed > maxChange) {RampSpeed -= maxChange;}
+			else if (RampSpeed < -maxChange) {RampSpeed += maxChange;}
+			else {RampSpeed = 0;}
+			
+			if (RampSpeed == 0 && Speed < STOP_SPEED && Speed > -STOP_SPEED)
+			{
+				Holding = true;
+				HoldCount = count;
+				ErrorSum = 0;
+				
+				Log[LogHead].tick = tick;
+				Log[LogHead].speed = StopSpeed;
+				Log[LogHead].distance = (count - StopCount) * mmPerTick;
+				
+				LogHead = (LogHead + 1 >= LOG_SIZE) ? 0 : LogHead + 1;
+				Stops++;
+				
+				p_Motor -> setBrake(true);
+				Hold(count);
+				return;
+			}
+			
+			command = RampSpeed;
+		}
+		else
+		{
+			//Float again for driving
+			if (Holding) {p_Motor -> setBrake(false);}
+			
+			Stopping = false;
+			Holding = false;
+		}
+		
+		//What it should take, more as the battery drops
+		feed = Q16mul(WHEEL_KV, command);
+		if (command > 0) {feed += WHEEL_KS;}
+		if (command < 0) {feed -= WHEEL_KS;}
+		
+		if (batteryMV > MIN_MV)
+		{
+			feed = (Q16) ((S64) feed * NOMINAL_MV / batteryMV);
+		}
+		
+		error = command - Speed;
+		out = feed + Q16mul(WHEEL_KP, error) + Q16mul(WHEEL_KI, ErrorSum);
+		power = Q16round(out);
+		
+		//Only integrate while the power has room to move, or the error would bring it back
+		if (power > 100)
+		{
+			power = 100;
+			if (error < 0) {ErrorSum += (Q16) ((S64) error * dt / 1000);}
+		}
+		else if (power < -100)
+		{
+			power = -100;
+			if (error > 0) {ErrorSum += (Q16) ((S64) error * dt / 1000);}
+		}
+		else
+		{
+			ErrorSum += (Q16) ((S64) error * dt / 1000);
+		}
+		
+		Power = (S8) power;
+		p_Motor -> setPWM(Power);
+	}
+	
+	
+/**************************************************************************************
+ * Getters
+ **************************************************************************************/
+/** @brief  Measured speed last given to @c Run(), Q16 mm/s
+ */
+	
+	Q16 WheelControlClass::GetSpeed(void)
+	{
+		return Speed;
+	}
+	
+/** @brief  Power last set, -100 to 100
+ */
+	
+	S8 WheelControlClass::GetPower(void)
+	{
+		return Power;
+	}
+	
+/** @brief  True while holding the wheel still after a stop
+ */
+	
+	bool WheelControlClass::IsHolding(void)
+	{
+		return Holding;
+	}
+	
+/** @brief  Stops since the start
+ */
+	
+	U16 WheelControlClass::GetStops(void)
+	{
+		return Stops;
+	}
+	
+	
+/**************************************************************************************
+ * Get Stop
+ **************************************************************************************/
+/** @brief  Read one of the logged stops
+ * 	@param   n   Which one, 0 is the newest
+ * 	@param   rec Where it is written
+ * 	@return  False if fewer than n + 1 have been logged
+ */
+	
+	bool WheelControlClass::GetStop(U8 n, StopRecord& rec)
+	{
+		if (n >= LOG_SIZE || n >= Stops) {return false;}
+		
+		rec = Log[(LogHead + LOG_SIZE - 1 - n) % LOG_SIZE];
+		
+		return true;
+	}
+	
+	
+/**************************************************************************************
+ * Hold
+ **************************************************************************************/
+/** @brief  Hold the wheel at the count it stopped at
+ *  @details The motor was put in brake mode when the hold started, which is
+ * 			 enough on its own against a small push. If the wheel is pushed
+ * 			 further it is driven back.
+ * 	@param   count The wheel's encoder count now
+ */
+	
+	void WheelControlClass::Hold(S32 count)
+	{
+		S32 error = HoldCount - count;
+		S32 power = 0;
+		
+		if (error > HOLD_DEADBAND) {power = Q16round(WHEEL_KS) + HOLD_KP * (error - HOLD_DEADBAND);}
+		if (error < -HOLD_DEADBAND) {power = -Q16round(WHEEL_KS) + HOLD_KP * (error + HOLD_DEADBAND);}
+		
+		if (power > HOLD_MAX) {power = HOLD_MAX;}
+		if (power < -HOLD_MAX) {power = -HOLD_MAX;}
+		
+		Power = (S8) power;
+		p_Motor -> setPWM(Power);
+	}
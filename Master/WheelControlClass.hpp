@@ -0,0 +1,151 @@
+//*************************************************************************************
+/** @file    WheelControlClass.hpp
+ *  @brief   Closed loop speed control for one drive wheel
+ *  @details Setting a power gives a different speed as the battery drains and
+ * 			 the load changes. This holds a speed in mm/s instead, from the
+ * 			 wheel's encoder.
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *	  \li 10-18-2026 ARB Stops ramp down, then brake and hold the wheel where it is
+ *	  \li 10-18-2026 ARB Speed comes from the odometry's wheel filter
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _WHEELCONTROLCLASS_H_
+#define _WHEELCONTROLCLASS_H_
+
+
+#ifdef HOST_BUILD
+#include "../lib/MotorSim.hpp"
+#else
+#include <Motor.h>
+#endif
+
+#include "../lib/FixedPoint.hpp"
+
+/**************************************************************************************
+ * Wheel Control Class Header
+ **************************************************************************************/
+/** @brief  PI speed controller with feed forward for one wheel.
+ *  @details Call @c Run() at a fixed rate with the wheel's speed from
+ *			 @c RobotClass::GetWheelSpeeds(), whose filter already smooths out
+ *			 the whole ticks. The nav task updates it every other drive period,
+ *			 so it is up to one nav period old on top of the filter's lag. Each
+ *			 call it:
+ *			 \li Feeds forward the power the wheel should need for the commanded
+ *				 speed, scaled up as the battery voltage drops
+ *			 \li Adds a PI correction on the speed error. The integral stops
+ *				 growing while the power is at its limit.
+ *
+ *			 A command of zero stops the wheel. The speed it is held to ramps
+ *			 down from where it was at @c STOP_DECEL, so a sudden stop doesn't
+ *			 skid or coast an unknown distance. Once the wheel has nearly stopped
+ *			 the motor is put in brake mode, and the wheel is held at that
+ *			 encoder count until a new speed is asked for. How far each stop took
+ *			 is logged, see @c GetStop().
+ *
+ *			 @c ecrobot::Motor starts in brake mode, which shorts the motor
+ *			 whenever the power is off. The controller floats the motor instead
+ *			 while it drives, so the brake doesn't pull the wheel down faster
+ *			 than the stop ramp or fight the PI at low power. Brake mode only
+ *			 goes on once the wheel is held, and off again with the next speed.
+ *
+ *			 Speeds are Q16 mm/s, so the controller needs the distance of one
+ *			 encoder tick, which changes when the wheels are calibrated.
+ */
+
+
+class WheelControlClass
+{
+
+public:
+
+	//Constructor
+	WheelControlClass(ecrobot::Motor* p_Motor);
+	
+	//Run the loop once, with the commanded and measured speeds in Q16 mm/s
+	void Run(Q16 command, Q16 speed, Q16 mmPerTick, U16 batteryMV, U32 tick);
+	
+	//Forget the integral and any stop
+	void Reset(void);
+	
+	//Measured speed last given to Run(), Q16 mm/s
+	Q16 GetSpeed(void);
+	
+	//Power last set
+	S8 GetPower(void);
+	
+	//One logged stop
+	struct StopRecord
+	{
+		U32 tick;      /**<When the wheel came to rest*/
+		Q16 speed;     /**<Speed when the stop was asked for, Q16 mm/s*/
+		Q16 distance;  /**<How far it went from then, Q16 mm*/
+	};
+	
+	//Number of stops kept in the log
+	static const U8 LOG_SIZE = 8;
+	
+	//Read one of the logged stops, 0 is the newest
+	bool GetStop(U8 n, StopRecord& rec);
+	
+	//Stops since the start
+	U16 GetStops(void);
+	
+	//True while holding the wheel still after a stop
+	bool IsHolding(void);
+	
+protected:
+
+	//Hold the wheel at HoldCount
+	void Hold(S32 count);
+
+	//Wheel being controlled
+	ecrobot::Motor* p_Motor;
+	
+	//Time of the last call, which Started says there has been
+	U32 LastTick;
+	bool Started;
+	
+	Q16 Speed;
+	Q16 ErrorSum;  /**<Speed error integrated over time, Q16 mm*/
+	S8 Power;
+	
+	//The stop being made
+	bool Stopping;
+	bool Holding;
+	Q16 RampSpeed;   /**<Speed the wheel is held to on the way down*/
+	Q16 StopSpeed;   /**<Speed when the stop was asked for*/
+	S32 StopCount;   /**<Encoder count when the stop was asked for*/
+	S32 HoldCount;   /**<Encoder count the wheel came to rest at*/
+	
+	//Logged stops
+	StopRecord Log[LOG_SIZE];
+	U8 LogHead;
+	U16 Stops;
+
+};
+
+
+//Fixes weird linker issues....
+#include "WheelControlClass.cpp"
+
+#endif
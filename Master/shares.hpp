@@ -7,6 +7,13 @@
  *
  *  Revised:
  *     \li 02-16-2015 ARB Original file
+ *     \li 10-18-2026 ARB Added the drive speed shares
+ *     \li 10-18-2026 ARB Added NAV_ROUTE and the course places
+ *     \li 10-18-2026 ARB Added the sonar reading share
+ *     \li 10-18-2026 ARB Added task_NavDone, NUM_NAV_STATES
+ *     \li 10-18-2026 ARB Added the nav move queue and NAV_STRAIGHT, NAV_TURN, NAV_FOLLOW_LINE
+ *     \li 10-18-2026 ARB Added the measured wheel speed share
+ *     \li 10-18-2026 ARB Added StatsPageOn
  *
  *  License:
  *		
@@ -26,6 +33,10 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 //*************************************************************************************
 
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _SHARES_H_
+#define _SHARES_H_
+
 
 /**************************************************************************************
  * PORT DEFINITIONS
@@ -43,6 +54,13 @@ extern const ePortS CommPort;
 extern const ePortM RightWheelPort;
 extern const ePortM LeftWheelPort;
 
+#include <Motor.h>
+
+//Wheel motors, defined in task_Navigation.cpp with the robot object. Only the
+//drive task sets their power, use setWheelSpeeds() to move them.
+extern ecrobot::Motor RightWheel;
+extern ecrobot::Motor LeftWheel;
+
 
 
 /**************************************************************************************
@@ -67,6 +85,7 @@ extern ecrobot::Lcd Display;
  * Shared Global Variables
  **************************************************************************************/
 #include "../lib/taskshare.hpp"
+#include "../lib/taskqueue.hpp"
 
 //------------MasterMind----------------
 
@@ -76,21 +95,113 @@ extern TaskShare<bool> task_MasterMindStart;
 extern TaskShare<bool> task_CommStart;
 
 //----------Nav----------------
+//Put one of these in task_NavState to start it. Nav puts NAV_IDLE back when it is done.
 #define NAV_IDLE 0
 #define NAV_TO_SUPPLY 1
 #define NAV_APPROACH_WALL 2
 #define NAV_BACK_UP 3
 #define NAV_TURN_AROUND 4
 #define NAV_TO_SCORE   5
+#define NAV_CALIBRATE  6
+#define NAV_ROUTE      7  //Drive the course route to task_NavGoal
+#define NAV_STRAIGHT   8  //Drive straight, queue only, arg in mm (negative backs up)
+#define NAV_TURN       9  //Turn in place, queue only, arg in degrees (positive is left)
+#define NAV_FOLLOW_LINE 10 //Follow the line until the aux light sees a cross line
+#define NUM_NAV_STATES 11 //Nav uses the numbers from here up inside itself
+
+//Places on the course, see CourseMap.hpp
+#define PLACE_START    0
+#define PLACE_SUPPLY   1
+#define PLACE_SCORE    2
+#define NUM_PLACES     3
 
 extern TaskShare<bool> task_NavStart;
 
 extern TaskShare<U8> task_NavState;
 
+//False while a nav state runs, true once the last one has finished
+extern TaskShare<bool> task_NavDone;
+
+//One nav state to run after the ones before it
+struct NavMove
+{
+	U8 state;  /**<A NAV_ state, not NAV_IDLE*/
+	S16 arg;   /**<mm for NAV_STRAIGHT, degrees for NAV_TURN, the place for NAV_ROUTE*/
+};
+
+//Moves waiting to run (Mind -> Nav). Use queueNavMove() to add to them. When a
+//state finishes nav goes straight on to the next move without stopping, and
+//without a cycle in between, and drives straight through into the next drive.
+extern TaskQueue<NavMove> NavQueue;
+
+//Nav states finished so far, queued or put in task_NavState
+extern TaskShare<U16> NavMovesDone;
+
+//Queue up a nav state, false if it isn't one or the queue is full. Defined in
+//task_Navigation.cpp.
+bool queueNavMove(U8 state, S16 arg);
+
+//Place for NAV_ROUTE to go to, set it before the state
+extern TaskShare<U8> task_NavGoal;
+
+//Encoder ticks each wheel turns for the robot to spin once in place. Set by the
+//nav task from the wheel geometry, 0 until it has done so.
+extern TaskShare<S32> TicksPerTurn;
+
+//Reads the wheel encoders for odometry. Called from the 1 ms interrupt, defined in
+//task_Navigation.cpp with the robot object.
+void OdometrySample(void);
+
+
+//----------Drive----------------
+//Speed for each wheel, in mm/s
+struct WheelSpeeds
+{
+	S16 left;
+	S16 right;
+};
+
+//Latest speeds asked for (Nav, LineFollow -> Drive). Use setWheelSpeeds() to change it.
+extern TaskShare<WheelSpeeds> DriveCommand;
+
+//Distance a wheel rolls per encoder tick, Q16 mm. Set by the nav task from the
+//wheel geometry, 0 until it has done so.
+extern TaskShare<S32> MmPerTick;
+
+//Measured speed of each wheel
+struct WheelRates
+{
+	S32 left;      /**<Q16 mm/s*/
+	S32 right;     /**<Q16 mm/s*/
+};
+
+//Filtered wheel speeds from the odometry (Nav -> Drive), put after each update
+extern TaskShare<WheelRates> MeasuredSpeeds;
+
+//Ask the drive task for a speed on each wheel, defined in task_Drive.cpp
+void setWheelSpeeds(S16 left, S16 right);
+
+
+//----------Sonar----------------
+//One sonar reading and when it was measured
+struct SonarReading
+{
+	S16 cm;    /**<Distance to the wall in cm*/
+	U32 tick;  /**<System tick the ping was measured at, 0 before the first one*/
+	U16 count; /**<Readings taken so far, changes when a new one comes in*/
+};
+
+//Latest sonar reading (Sonar -> Nav). Only the sonar task touches the I2C bus.
+extern TaskShare<SonarReading> SonarData;
+
 
 //----------LineFollow----------------
 extern TaskShare<bool> task_LFStart;
 
+//Hand the wheels to the line follower, going straight until it takes over.
+//Defined in task_LineFollow.cpp.
+void startLineFollow(void);
+
 extern TaskShare<S16> black_limit;
 
 //-----------Comm-----------------
@@ -100,17 +211,23 @@ extern TaskShare<bool> task_CommStart;
 //Shared vaiable to tell others when the comm task is ready
 extern TaskShare<bool> CommReady;
 
+//True while the comm task shows the link statistics page, which takes the whole
+//screen. Don't write to the screen while it is set.
+extern TaskShare<bool> StatsPageOn;
+
 //Shared variable containing the dataID information so the reciever knows what to do
 extern TaskShare<U8> ShareMsgID;
 
 //Shared vaiable to tell others when a message is ready to be recieved (Comm->SMind)
 extern TaskShare<bool> MsgReady2Get;
 
-//Shared vaiable to tell others when a message is ready to be sent (SMind->Comm)
-extern TaskShare<bool> MsgReady2Send;
-
-
-
-
+//Queue of message IDs waiting to be sent to the other brick (Mind->Comm).
+//Use Comm.Post() to add to it.
+struct CommTxMsg;
+extern TaskQueue<CommTxMsg> CommTxQueue;
 
+//The link itself, from lib/CommEngine.hpp
+class CommEngine;
+extern CommEngine Comm;
 
+#endif
@@ -0,0 +1,221 @@
+//*************************************************************************************
+/** @file    task_Drive.cpp
+ *  @brief   A task which holds the speed of each drive wheel
+ *  @details The nav and line follow tasks ask for a speed on each wheel in mm/s
+ * 			 with @c setWheelSpeeds(). This task is the only one that sets the
+ * 			 motor powers, from a closed loop on each wheel's encoder, so a speed
+ * 			 comes out the same whatever the battery level.
+ *
+ *  Revised:
+ *     \li 10-18-2026 ARB Original file
+ *     \li 10-18-2026 ARB Shows the stopping distance of each stop
+ *     \li 10-18-2026 ARB Wheel loops use the measured speeds from the nav task
+ *     \li 10-18-2026 ARB Leaves the screen alone while the link statistics page is shown
+ *
+ *  License:
+ *		
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+/**************************************************************************************
+ * Include Kernel Files
+ **************************************************************************************/
+
+extern "C" {
+#include "ecrobot_interface.h"
+}
+
+/**************************************************************************************
+ * Include ECROBOT Files
+ **************************************************************************************/
+#include <Motor.h>
+
+/**************************************************************************************
+ * Include Personally Written Files
+ **************************************************************************************/
+#include "../lib/taskshare.hpp"
+#include "shares.hpp"
+#include "../lib/ExtraFunctions.hpp"
+#include "WheelControlClass.hpp"
+
+/**************************************************************************************
+ * Include NXTexpanded Lib Files
+ **************************************************************************************/
+#include "../../nxtOSEK/NXtpandedLib/src/NNxt.hpp"
+
+
+/**************************************************************************************
+ * Constants
+ **************************************************************************************/
+
+#define DRIVE_PERIOD      10 //ms per pass through the speed loops
+
+
+/**************************************************************************************
+ * Global Variables
+ **************************************************************************************/
+
+//Speed loop for each wheel
+WheelControlClass RightControl(&RightWheel);
+WheelControlClass LeftControl(&LeftWheel);
+
+TaskShare<WheelSpeeds> DriveCommand;
+
+TaskShare<S32> MmPerTick;
+
+TaskShare<WheelRates> MeasuredSpeeds;
+
+
+
+/**************************************************************************************
+ * Set Wheel Speeds
+ **************************************************************************************/
+/** @brief   Ask for a speed on each wheel
+ *  @details Can be called from any task. The drive task picks it up on its
+ * 			 next pass.
+ *  @param   left  Left wheel speed in mm/s, negative to go backwards
+ *  @param   right Right wheel speed in mm/s, negative to go backwards
+ */
+
+void setWheelSpeeds(S16 left, S16 right)
+{
+	WheelSpeeds cmd;
+	
+	cmd.left = left;
+	cmd.right = right;
+	
+	DriveCommand.put(cmd);
+}
+
+
+
+/**************************************************************************************
+ * Task Drive Constructor
+ **************************************************************************************/
+/** @brief   Constructor for the drive task
+ *  @details Starts with both wheels stopped, and waits for the nav task to set
+ * 			 @c MmPerTick from the wheel geometry.
+ */
+
+
+void DriveConstructor(void)
+{
+	setWheelSpeeds(0, 0);
+	
+	RightControl.Reset();
+	LeftControl.Reset();
+	
+	while (MmPerTick.get() == 0) {NNxt::sleep(10);}
+}
+
+
+
+/**************************************************************************************
+ * Task Drive Run Method (infinite loop)
+ **************************************************************************************/
+/** @brief   Run method for the drive task
+ *  @details Runs both wheel loops every @c DRIVE_PERIOD ms with the latest
+ * 			 command and the latest wheel speeds from the nav task's odometry.
+ * 			 Each time the wheels come to rest after a stop, how far
+ * 			 the stop took is put on the screen.
+ */
+
+
+void DriveRun(void)
+{
+	U32 currentTime;
+	WheelSpeeds cmd;
+	WheelRates speeds;
+	U16 battery;
+	Q16 mmPerTick;
+	U16 stops = 0;
+	WheelControlClass::StopRecord right;
+	WheelControlClass::StopRecord left;
+	
+	//Go forever!
+	while(true)
+	{		
+		currentTime = NNxt::getTick();		
+		
+		cmd = DriveCommand.get();
+		speeds = MeasuredSpeeds.get();
+		mmPerTick = MmPerTick.get();
+		battery = ecrobot_get_battery_voltage();
+		
+		RightControl.Run(INT2Q16(cmd.right), speeds.right, mmPerTick, battery, currentTime);
+		LeftControl.Run(INT2Q16(cmd.left), speeds.left, mmPerTick, battery, currentTime);
+		
+		//Log each stop once both wheels have come to rest
+		if (RightControl.GetStops() != stops && LeftControl.IsHolding() && RightControl.IsHolding())
+		{
+			stops = RightControl.GetStops();
+			
+			if (RightControl.GetStop(0, right) && LeftControl.GetStop(0, left))
+			{
+				if (!StatsPageOn.get())
+				{
+					Display.cursor(0,DEBUG);
+					Display.putf("sdsd\n", "Stop ", Q16round((right.distance + left.distance) / 2), 0, " mm @", Q16round((right.speed + left.speed) / 2), 0);
+					Display.disp();
+				}
+			}
+		}
+		
+		//Let other tasks run
+		sleep_from_for(currentTime, DRIVE_PERIOD);
+		
+	}//End while
+}
+	
+
+
+
+/**************************************************************************************
+ * Task Drive
+ **************************************************************************************/
+/** @brief   Drive task
+ *  @details Waits until the nav task is allowed to start, since it is the one
+ * 			 that sets the wheel geometry. Then runs the constructor and the run
+ * 			 method. The run method will *never* exit. And if it somehow does the
+ * 			 task will just exit.  
+ */
+
+
+extern "C"
+{
+
+
+TASK(DriveTask)
+{
+	//Wait until permission to start is given
+
+	while(task_NavStart.get() != true) 
+	{	
+		//Let other tasks run
+		NNxt::sleep(500);
+	}
+	
+	//Runs once
+	DriveConstructor();
+
+	//This loops forever
+	DriveRun();
+	
+	//shouldn't ever get here
+	TerminateTask();
+}
+
+}
@@ -6,6 +6,12 @@
  *
  *  Revised:
  *     \li 03-28-2015 ARB Original file
+ *     \li 10-18-2026 ARB Rotate() no longer resets the wheel encoders
+ *     \li 10-18-2026 ARB Rotate() turns by degrees, from the calibrated geometry
+ *     \li 10-18-2026 ARB Wheel speeds are asked of the drive task instead of setting powers
+ *     \li 10-18-2026 ARB Drives on the pass it is started, added startLineFollow()
+ *     \li 10-18-2026 ARB Leaves the screen alone while the link statistics page is shown
+ *     \li 10-18-2026 ARB Rotate() sleeps between encoder checks instead of spinning
  *
  *  License:
  *		
@@ -53,19 +59,16 @@
  * Constants
  **************************************************************************************/
 
-#define STD_POWER 50    //Power the motors should spin at if going straight along edge
+#define STD_SPEED    150 //Wheel speed in mm/s if going straight along edge
 //#define EDGE_VAL 600    //Brightness reading of the edge the robot needs to follow
-#define SCALE    1     //Scale the feedback 
+#define EDGE_GAIN    3   //mm/s of steering per unit of brightness off the edge
+#define ROTATE_SPEED 100 //Wheel speed in mm/s to spin in place
 
 
 /**************************************************************************************
  * Global Variables
  **************************************************************************************/
 
-//Make motor objects
-ecrobot::Motor RightWheel (RightWheelPort);
-ecrobot::Motor LeftWheel (LeftWheelPort);
-
 //Create a normal light sensor object from the one light sensor I do have
 ecrobot::LightSensor MainLight(MainLightPort);
 
@@ -77,31 +80,64 @@ S16 EDGE_VAL;
 
 
 
-void Rotate(S8 angle, S8 dir)
+/**************************************************************************************
+ * Rotate
+ **************************************************************************************/
+/** @brief   Spin in place
+ *  @details The encoder ticks for the turn come from @c TicksPerTurn, which the
+ * 			 nav task works out from the (calibrated) wheel geometry. Waits for
+ * 			 it if the nav task hasn't set it yet. The encoder is checked once
+ * 			 a ms while turning.
+ *  @param   angle How far to turn, in degrees
+ *  @param   dir   +1 to turn left, -1 to turn right
+ */
+
+void Rotate(S16 angle, S8 dir)
 {
+	S32 Rcount = 0;
+	S32 ticks;
 	
-	//dir = +1 or -1
+	while (TicksPerTurn.get() == 0) {NNxt::sleep(10);}
 	
-	S32 Rcount = 0;;
+	ticks = (S32) angle * TicksPerTurn.get() / 360;
 	
-	RightWheel.reset();
-	LeftWheel.reset();
+	//Measure from here instead of resetting the encoder, the odometry needs it
+	S32 Rstart = RightWheel.getCount();
 	
-	RightWheel.setPWM(dir * 30);
-	LeftWheel.setPWM(dir * (-30));
+	setWheelSpeeds(-dir * ROTATE_SPEED, dir * ROTATE_SPEED);
 	
-	while(std::abs(Rcount) < angle)
+	//The encoder moves about a tick every 3 ms at this speed, so checking each
+	//ms is plenty and leaves the CPU to the lower priority tasks
+	while(std::abs(Rcount) < ticks)
 	{
-		Rcount = RightWheel.getCount();
+		NNxt::sleep(1);
+		Rcount = RightWheel.getCount() - Rstart;
 	}
 	
-	RightWheel.setPWM(0);
-	LeftWheel.setPWM(0);
+	setWheelSpeeds(0, 0);
 	
 }
 
 
 
+/**************************************************************************************
+ * Start Line Follow
+ **************************************************************************************/
+/** @brief   Hand the wheels to the line follower
+ *  @details Asks for @c STD_SPEED on both wheels before raising @c task_LFStart,
+ * 			 so the wheels are never left on a zero command while the line
+ * 			 follow task waits for its next pass. A zero command would start a
+ * 			 stop and brake the wheels. Can be called from any task.
+ */
+
+void startLineFollow(void)
+{
+	setWheelSpeeds(STD_SPEED, STD_SPEED);
+	task_LFStart.put(true);
+}
+
+
+
 /**************************************************************************************
  * Task Line Follow Constructor
  **************************************************************************************/
@@ -117,19 +153,20 @@ void LFConstructor(void)
 	
 	task_LFStart.put(false);	
 	
-	Rotate(45,-1);
+	//Look either side of the line to find the edge value
+	Rotate(15,-1);
 	
 	NNxt::sleep(100);
 	b1 = MainLight.get();
 	
-	Rotate(90,1);
+	Rotate(30,1);
 	NNxt::sleep(100);
 	b2 = MainLight.get();
 	
 	EDGE_VAL = (b1+b2)/2;
 	black_limit.put(EDGE_VAL);
 	
-	Rotate(45,-1);
+	Rotate(15,-1);
 	
 }
 
@@ -149,8 +186,8 @@ void LFRun(void)
 	U32 currentTime;
 	enum state_t {IDLE, FOLLOWING} state = IDLE;
 	S16 brightness;
-	S16 Rpow;
-	S16 Lpow;
+	S16 Rspeed;
+	S16 Lspeed;
 	
 	//Go forever!
 	while(true)
@@ -161,27 +198,32 @@ void LFRun(void)
 		{
 			case IDLE:
 			
-				if(task_LFStart.get()==true)
+				if(task_LFStart.get()!=true)
 				{
-					state = FOLLOWING;
+					break;
 				}
 				
-				break;
+				//Steer on the same pass it is started, there's no time to lose
+				state = FOLLOWING;
+				
+				//Fall through
 				
 			case FOLLOWING:
 				
 				brightness = MainLight.get();
 				
-				Display.cursor(0,DEBUG);
-				Display.putf("sd\n", "light: ", brightness,0);
-				Display.disp();
+				if (!StatsPageOn.get())
+				{
+					Display.cursor(0,DEBUG);
+					Display.putf("sd\n", "light: ", brightness,0);
+					Display.disp();
+				}
 				
 				//This will follow the right edge of the line - to change sides, switch the signs
-				Rpow = STD_POWER + (EDGE_VAL - brightness)/SCALE;
-				Lpow = STD_POWER - (EDGE_VAL - brightness)/SCALE;
+				Rspeed = STD_SPEED + (EDGE_VAL - brightness)*EDGE_GAIN;
+				Lspeed = STD_SPEED - (EDGE_VAL - brightness)*EDGE_GAIN;
 				
-				RightWheel.setPWM((S8)Rpow);
-				LeftWheel.setPWM((S8)Lpow);
+				setWheelSpeeds(Lspeed, Rspeed);
 				
 				if(task_LFStart.get()==false)
 				{
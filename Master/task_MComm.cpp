@@ -6,6 +6,9 @@
  *
  *  Revised:
  *     \li 03-04-2015 ARB Original file
+ *     \li 10-18-2026 ARB Link handling moved to the shared CommEngine in lib/
+ *     \li 10-18-2026 ARB Slave tuning parameters are sent after the handshake
+ *     \li 10-18-2026 ARB Added StatsPageOn for the link statistics page
  *
  *  License:
  *		
@@ -25,16 +28,9 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 //*************************************************************************************
 
-/**************************************************************************************
- * Include C/C++ Files
- **************************************************************************************/
-#include "../../yagarto-old/arm-none-eabi/include/c++/4.6.2/cstring"
-
 /**************************************************************************************
  * Include ECROBOT Files
  **************************************************************************************/
-#include <Rs485.h>
-#include <Speaker.h>
 #include <Lcd.h>
 
 /**************************************************************************************
@@ -43,7 +39,8 @@
 #include "../lib/taskshare.hpp"
 #include "shares.hpp"
 #include "../lib/ExtraFunctions.hpp"
-#include "../lib/MessageClass.hpp"
+#include "../lib/CommEngine.hpp"
+#include "../lib/ParamTable.hpp"
 
 /**************************************************************************************
  * Include NXTexpanded Lib Files
@@ -53,225 +50,136 @@
 
 /**************************************************************************************
  * Constants
- * **************************************************************************************/
-#define TIMEOUT 50
+ **************************************************************************************/
+#define PARAM_TIMEOUT 200 //ms to wait for the slave to acknowledge the tuning table
+#define PARAM_TRIES   5   //Times the tuning table is sent before giving up
+#define PARAM_POLL    10  //ms between polls of the link while waiting
+
+
+/**************************************************************************************
+ * Slave Tuning
+ **************************************************************************************/
+//The values from ParamTable.hpp, sent to the slave during the handshake
+ParamTable SlaveTuning(SlaveTuningValues);
 
 
 /**************************************************************************************
  * Global Variables
  **************************************************************************************/
 TaskShare<bool> CommReady;
+TaskShare<bool> StatsPageOn;
 TaskShare<U8> ShareMsgID;
 TaskShare<bool> MsgReady2Get;
-TaskShare<bool> MsgReady2Send;
+TaskQueue<CommTxMsg> CommTxQueue;
 
-ecrobot::Speaker mSpeak;
+//The link to the slave, received messages go to the ShareMsgID mailbox
+CommEngine Comm(CommEngine::roleMaster, &CommTxQueue, &ShareMsgID, &MsgReady2Get);
+
+//Answer from the slave to the last tuning table sent
+bool ParamAckIn = false;
+U8 ParamAckSum = 0;
 
 
 /**************************************************************************************
- * Send Ack
+ * Frame Handler
  **************************************************************************************/
-/** @brief   Send acknowledgement of message
- *  @details 
- *  
+/** @brief   Handle frames from the slave
+ *  @details Only the checksum that acknowledges the tuning table is expected.
+ *  @param   dType The type of data in the frame
+ *  @param   dID   What the frame holds
+ *  @param   data  The data in the frame
+ *  @param   len   Number of data bytes
  */
 
-void SendAck(void)
+void CommFrame(MessageClass::comDatatype dType, MessageClass::comDataID dID, U8* data, U8 len)
 {
-	MessageClass AckMsg;
-
-	MessageClass::comDataID   msgID = MessageClass::idAckMsg;
- 
-	AckMsg.SendMsgSimple(msgID);
+	(void) dType;
+	
+	if (dID == MessageClass::idParamAck && len == 1)
+	{
+		ParamAckSum = data[0];
+		ParamAckIn = true;
+	}
 }
 
 
-
 /**************************************************************************************
- * Wait for Ack
+ * Send Slave Tuning
  **************************************************************************************/
-/** @brief    Was there acknowledgement of message?
- *  @details 
- *  
+/** @brief   Download the tuning table to the slave
+ *  @details Sends the whole table as one frame and waits for the slave to answer
+ * 			 with the checksum of what it stored. The table is sent again if the
+ * 			 checksum doesn't match or no answer comes in time.
+ *  @return  False if the slave never confirmed the table, it is then running
+ * 			 on its own defaults
  */
 
-bool isAck(void)
+bool SendSlaveTuning(void)
 {
-	bool ack = false;	
-	MessageClass AckMsg;	
-	MessageClass::comDataID   msgID = MessageClass::idNoMsg;
-	
-	msgID = AckMsg.GetMsgSimple();
-		
-		if(msgID == MessageClass::idAckMsg)
+	U8 sum = CommEngine::CRC8(0, SlaveTuning.data(), ParamTable::TABLE_BYTES);
+	U32 start;
+
+	for (U8 tries = 0; tries < PARAM_TRIES; tries++)
+	{
+		if (tries > 0)
 		{
-			ack = true;			
+			Comm.CountRetransmit();
 		}
-	
-	return ack;	
-}
 
+		ParamAckIn = false;
+		Comm.SendFrame(SlaveTuning.data(), MessageClass::typeFloat, MessageClass::idParamTable, ParamTable::TABLE_BYTES);
 
-/**************************************************************************************
- * Easy function to write debug msgs
- **************************************************************************************/
-/** @brief   Write sequential debug msgs
- *  @details This function writes messages on the screen one line
- * 			 at a time and then loops back and erases old stuff after a while.
- * @param    msg The message to write
- * 		
- */
+		start = NNxt::getTick();
 
-U8 curLine = 1;
+		while (ParamAckIn == false && NNxt::getTick() - start < PARAM_TIMEOUT)
+		{
+			Comm.Poll();
+			NNxt::sleep(PARAM_POLL);
+		}
 
-void debug (const char* msg)
-{
-	
+		if (ParamAckIn && ParamAckSum == sum)
+		{
+			return true;
+		}
+	}
 
-	Display.clearRow(curLine);
-	Display.cursor(0,curLine);
-	Display.putf("s\n", msg);
-	Display.disp();
-	
-	curLine++;
-	if(curLine > 7) curLine = 1;
+	return false;
 }
 
 
-void debugnum (U8 msg, U8 dir)
-{
-
-	Display.clearRow(curLine);
-	Display.cursor(0,curLine);
-	Display.putf("dsd\n", msg,0, ",", dir,0);
-	Display.disp();
-	
-	curLine++;
-	if(curLine > 7) curLine = 1;
-}
-
 /**************************************************************************************
  * Task Comm Constructor
  **************************************************************************************/
 /** @brief   Constructor for the comm task
- *  @details Sets up Wake message object and sends it to the slave to check if it is alive
- * 			 It waits for ack from the slave before proceeding
+ *  @details Clears the mailbox, wakes up the link to the slave and sends it
+ * 			 the tuning table.
  *  
  */
 
 void CommConstructor(void)
 {
+	bool tuned;
+	
 	//Initialze Shared Variables
 	ShareMsgID.put(0);
 	MsgReady2Get.put(false);
-	MsgReady2Send.put(false);
 	
-	MessageClass WakeMsg;
+	Comm.setFrameHandler(CommFrame);
+	Comm.setStatsPageFlag(&StatsPageOn);
 	
-	//Wait for Wake Message	
-	while  (WakeMsg.GetMsgSimple() != MessageClass::idWakeMsg)
-	{
-		NNxt::sleep(200);
-	}
+	//Returns once the slave has answered
+	Comm.Handshake();
+	
+	tuned = SendSlaveTuning();
 	
-	SendAck();
 	CommReady.put(true);
 	
 	//Comm is now ready for operation.	
 	//Notify user
-	//mSpeak.playTone(500,50,20);
 	Display.cursor(0,COMM_LINE);
-	Display.putf("s\n", "Comm Ready");
+	Display.putf("s\n", (tuned) ? "Comm Ready" : "Comm Ready, NoTn");
 	Display.disp();
-	
-}
-
-
-
-/**************************************************************************************
- * Task Comm Run Method (infinte loop)
- **************************************************************************************/
-/** @brief   Run method for the comm task
- *  @details Runs a loop which sends messages to the slave. It checks to make sure
- * 			 Ack is recieved and then waits until the slave has completed the requested actions
-*/
-
-
-void CommRun(void)
-{
-	//Task Vars
-	enum state_t {IDLE, SEND, GET} state = IDLE;
-	U32 currentTime;
-	
-	//Message Vars
-	MessageClass* p_curMsg = new MessageClass;
-	MessageClass::comDataID   msgID;
-
-	
-	//Go forever!
-	while(true)
-	{
-		
-		currentTime = NNxt::getTick();
-		
-		switch (state)
-		{
-			
-			case IDLE:
-				
-				//Check if a there is an incomming message
-				p_curMsg -> GetMsgSimple();
-				if (p_curMsg -> isEmptySimple() == false)
-				{
-					state = GET;
-					break;
-				}
-				
-				//Check if there is a message to send
-				if (MsgReady2Send.get() == true)
-				{
-					state = SEND;
-				}
-				
-				break;
-			
-			
-			case SEND:
-				
-				//Send the message
-				msgID = static_cast<MessageClass::comDataID> (ShareMsgID.get());
-				p_curMsg -> SendMsgSimple(msgID);
-			
-// 				debugnum(ShareMsgID.get(),1);
-				
-				MsgReady2Send.put(false);
-				state = IDLE;
-				break;
-				
-			
-			case GET:
-				
-				//Get the message info
-				msgID = p_curMsg -> GetMsgDataSimple();
-				
-				//Get message info
-				ShareMsgID.put(msgID);
-				MsgReady2Get.put(true);
-				
-// 				debugnum(ShareMsgID.get(),0);
-
-				state = IDLE;	
-			
-				break;
-					
-		}//End switch
-		
-		//Let other tasks run
-		sleep_from_for(currentTime, 10);
-		
-	}//End while
 }
-	
 
 
 
@@ -280,7 +188,7 @@ void CommRun(void)
  **************************************************************************************/
 /** @brief   Comm task
  *  @details Waits until the start variable is set. Then runs the 
-*	     constructor and the run method. The run method will 
+*	     constructor and the engine's run method. The run method will 
 *	     *never* exit. And if it somehow does the task will just
 *	      exit.  
  */
@@ -304,7 +212,7 @@ TASK(CommTask)
 	CommConstructor();
 
 	//This loops forever
-	CommRun();
+	Comm.Run();
 	
 	//shouldn't ever get here
 	TerminateTask();
@@ -6,6 +6,7 @@
  *
  *  Revised:
  *     \li 02-17-2015 ARB Original file
+ *     \li 10-18-2026 ARB Odometry sampling added to the 1 ms hook
  *
  *  License:
  *		
@@ -122,6 +123,8 @@ void user_1ms_isr_type2(void)
 	}
 	
 	AuxLight.processBackground();
+	
+	OdometrySample();
 }
 
 
@@ -8,6 +8,9 @@
  *
  *  Revised:
  *     \li 02-16-2015 ARB Original file
+ *     \li 10-18-2026 ARB Holding the run button at start up calibrates the wheel geometry
+ *     \li 10-18-2026 ARB Queues the nav moves instead of waiting for each one
+ *     \li 10-18-2026 ARB Leaves the screen alone while the link statistics page is shown
  *
  *  License:
  *		
@@ -39,7 +42,7 @@
 #include "../lib/taskshare.hpp"
 #include "shares.hpp"
 #include "../lib/ExtraFunctions.hpp"
-#include "../lib/MessageClass.hpp"
+#include "../lib/CommEngine.hpp"
 
 /**************************************************************************************
  * Include NXTexpanded Lib Files
@@ -74,8 +77,7 @@ ecrobot::Speaker mSpeak;
 
 void SendMsg(MessageClass::comDataID msgID)
 {
-	ShareMsgID.put((U8) msgID);
-	MsgReady2Send.put(true);	
+	Comm.Post(msgID);
 }
 
 
@@ -117,10 +119,13 @@ void debug (const char* msg)
 {
 	static U8 curLine = 1;
 
-	Display.clearRow(curLine);
-	Display.cursor(0,curLine);
-	Display.putf("s\n", msg);
-	Display.disp();
+	if (!StatsPageOn.get())
+	{
+		Display.clearRow(curLine);
+		Display.cursor(0,curLine);
+		Display.putf("s\n", msg);
+		Display.disp();
+	}
 	
 	curLine++;
 	if(curLine > 7) curLine = 1;
@@ -153,19 +158,25 @@ void constructor(void)
 	//Make sure we recieved the init done message
 	if (ShareMsgID.get() == (U8) MessageClass::idInitDone)
 	{
-		Display.cursor(0,MIND_LINE);
-		Display.putf("s\n", "MasterMind Ready");
-		Display.disp();
+		if (!StatsPageOn.get())
+		{
+			Display.cursor(0,MIND_LINE);
+			Display.putf("s\n", "MasterMind Ready");
+			Display.disp();
+		}
 	}
 	//Otherwise throw an error
 	else
 	{
 		mSpeak.playTone(500,1000,20);
-		Display.cursor(0,MIND_LINE);
-		Display.putf("s\n", "ERROR!!!");
-		Display.cursor(0,DEBUG);
-		Display.putf("d\n", ShareMsgID.get(),0);
-		Display.disp();
+		if (!StatsPageOn.get())
+		{
+			Display.cursor(0,MIND_LINE);
+			Display.putf("s\n", "ERROR!!!");
+			Display.cursor(0,DEBUG);
+			Display.putf("d\n", ShareMsgID.get(),0);
+			Display.disp();
+		}
 		
 		NNxt::sleep(10000);
 	}
@@ -187,15 +198,27 @@ void constructor(void)
 
 void run(void)
 {
-	Display.clear(true);
-	Display.putf("s\n", "Master Running");
-	Display.disp();
+	U16 moves;
 	
-	task_NavState.put(NAV_TO_SUPPLY);
-	while (task_NavState.get() == NAV_TO_SUPPLY) {NNxt::sleep(50);}
+	if (!StatsPageOn.get())
+	{
+		Display.clear(true);
+		Display.putf("s\n", "Master Running");
+		Display.disp();
+	}
+	
+	//Hold the run button at start up to measure the wheel geometry first
+	if (ecrobot_is_RUN_button_pressed())
+	{
+		task_NavState.put(NAV_CALIBRATE);
+		while (task_NavState.get() == NAV_CALIBRATE) {NNxt::sleep(50);}
+	}
 	
-	task_NavState.put(NAV_APPROACH_WALL);
-	while (task_NavState.get() == NAV_APPROACH_WALL) {NNxt::sleep(50);}
+	//Nav runs these back to back, the count says when both are done
+	moves = NavMovesDone.get();
+	queueNavMove(NAV_TO_SUPPLY, 0);
+	queueNavMove(NAV_APPROACH_WALL, 0);
+	while ((U16) (NavMovesDone.get() - moves) < 2) {NNxt::sleep(50);}
 	
 	
 	
@@ -7,6 +7,23 @@
  *
  *  Revised:
  *     \li 03-04-2015 ARB Original file
+ *     \li 10-18-2026 ARB Odometry runs from encoder samples taken in the 1 ms interrupt
+ *     \li 10-18-2026 ARB Odometry is corrected at line crossings
+ *     \li 10-18-2026 ARB Wall distance is filtered from the sonar and odometry
+ *     \li 10-18-2026 ARB Added the wheel geometry calibration
+ *     \li 10-18-2026 ARB goStraight() holds the odometry heading instead of balancing counts
+ *     \li 10-18-2026 ARB Drive moves follow a jerk limited profile instead of a fixed power
+ *     \li 10-18-2026 ARB Wheel speeds are asked of the drive task instead of setting powers
+ *     \li 10-18-2026 ARB NAV_TO_SCORE follows a waypoint path with pure pursuit
+ *     \li 10-18-2026 ARB NAV_TURN_AROUND turns on a profile and stops centered on the line
+ *     \li 10-18-2026 ARB Field geometry and routes come from CourseMap.hpp, added NAV_ROUTE
+ *     \li 10-18-2026 ARB Sonar readings come from the sonar task instead of the I2C bus
+ *     \li 10-18-2026 ARB Faster wall approach which holds back by the wall estimate's error
+ *     \li 10-18-2026 ARB NavRun steps a table of nav states instead of a switch
+ *     \li 10-18-2026 ARB Runs a queue of nav moves back to back, driving through between them
+ *     \li 10-18-2026 ARB NAV_TURN_AROUND hands over to the line follower without stopping
+ *     \li 10-18-2026 ARB Leaves the screen alone while the link statistics page is shown
+ *     \li 10-18-2026 ARB Removed the old wall approach constants
  *
  *  License:
  *		
@@ -26,11 +43,6 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 //*************************************************************************************
 
-/**************************************************************************************
- * Include C/C++ Files
- **************************************************************************************/
-#include "../../yagarto-old/arm-none-eabi/include/c++/4.6.2/cmath"
-
 /**************************************************************************************
  * Include ECROBOT Files
  **************************************************************************************/
@@ -38,7 +50,6 @@
 #include <Speaker.h>
 #include <LightSensor.h>
 #include <NxtColorSensor.h>
-#include <SonarSensor.h>
 
 /**************************************************************************************
  * Include Personally Written Files
@@ -47,6 +58,11 @@
 #include "shares.hpp"
 #include "../lib/ExtraFunctions.hpp"
 #include "RobotClass.hpp"
+#include "LandmarkClass.hpp"
+#include "WallFilterClass.hpp"
+#include "ProfileClass.hpp"
+#include "PursuitClass.hpp"
+#include "CourseMap.hpp"
 
 /**************************************************************************************
  * Include NXTexpanded Lib Files
@@ -61,27 +77,48 @@
 #define DIST2CENTER 	  1  //inches
 
 #define BLACKLIMIT        50 //Less than this is considered black
-#define CROSS_FIELD_POWER 50  //speed of motors to cross field
 
 
-#define Kp_STRAIGHT       0.1  //Gain for straight controller in power/tick
-#define Ki_STRAIGHT       1  //Ki for straight controller in power/tick*dT
-#define MIN_DELTA         -10 //Min delta power for controller
-#define MAX_DELTA         10  //Max delta for controller
+#define NAV_PERIOD        20 //ms per pass through the nav loop
+
+#define HEADING_KP        FLOAT2Q16(6.0)  //Heading gain in (mm/s)/degree
+#define HEADING_KI        FLOAT2Q16(3.0)  //Heading gain in (mm/s)/(degree*s)
+#define HEADING_KD        FLOAT2Q16(0.15) //Heading gain in (mm/s)/(degree/s)
+#define HEADING_MAX_DELTA 120             //Most wheel speed the heading controller steers with, mm/s
+#define MAX_WHEEL_SPEED   400             //mm/s, about what a wheel can do at full power
 
 
-#define FORWARD_SPEED     25
 #define INCH2CM           2.54
-#define DIST_FROM_WALL    3  //inches from wall
-#define Kp                5  //Scale for wall approach controller
-#define Ki                1  //Gain for wall approach controller
-#define LONG_ENOUGH       10 //Number of cylces of being close enough to trigger stop
-#define MIN_POWER         15 //Minimum power the motors need to move slowly
 
-#define BACK_DIST         9 //Inches to back up from wall
-#define BACKUP_SPEED      -20 //Speed to back up with
+#define SONAR_STALE       200  //ms after which a sonar reading is too old to use
+
+#define PROFILE_VEL       250  //Top speed of a drive move in mm/s
+#define PROFILE_ACCEL     600  //Most accel of a drive move in mm/s^2
+#define PROFILE_JERK      6000 //Most jerk of a drive move in mm/s^3
+
+#define DRIVE_KP          FLOAT2Q16(4.0)  //mm/s per mm behind the profile
+
+#define WALL_VEL          350  //Top speed of the wall approach in mm/s
+#define WALL_ACCEL        800  //Most accel of the wall approach in mm/s^2
+#define WALL_JERK         8000 //Most jerk of the wall approach in mm/s^3
+#define BRAKE_SIGMAS      2    //Wall error the approach holds back by at WALL_VEL, in sigmas
+
+#define NAV_BLEND_DIST    300  //mm a straight plans past its end when a wall or route follows
 
-#define NUM_LOOPS         15
+#define TURN_VEL          180  //Top turn rate in degrees/s
+#define TURN_ACCEL        540  //Most turn accel in degrees/s^2
+#define TURN_JERK         5400 //Most turn jerk in degrees/s^3
+#define TURN_KP           FLOAT2Q16(4.0) //(degrees/s) per degree behind the profile
+#define TURN_SEARCH       30   //Degrees from the end of a turn to watch for the line, and past it to keep looking
+#define TURN_SEARCH_VEL   45   //Turn rate in degrees/s while looking past the end of a turn
+#define TURN_AROUND_ANGLE 180  //Degrees to turn around, positive turns left
+#define LINE_HALF_ANGLE   FLOAT2Q16(7.1) //Half the line as MainLight sweeps it: atan(9.5 mm / 76 mm), degrees
+
+#define CAL_SPEED         100 //Wheel speed for the calibration runs, mm/s
+#define CAL_TURNS         2  //Full spins to measure the wheel base over
+
+#define SENSOR_AUX        0  //Index of AuxLight in the landmark sensor table
+#define SENSOR_MAIN       1  //Index of MainLight in the landmark sensor table
 
 
 /**************************************************************************************
@@ -99,331 +136,1336 @@ ecrobot::NxtColorSensor AuxLight(AuxLightPort, sMode);
 //Create a normal light sensor object from the one light sensor I do have
 ecrobot::LightSensor MainLight(MainLightPort);
 
-//Create as sonar sensor object to see distance
-ecrobot::SonarSensor Sonar(SonarPort);
-
 //Robot class to hold position/velocity data
 RobotClass myBot(&LeftWheel, &RightWheel);
 
+//Light sensors, in the order of SENSOR_AUX and SENSOR_MAIN
+const LandmarkClass::Sensor LineSensors[] =
+{
+	{FLOAT2Q16(DIST2CENTER * INCH2CM * 10), 0, 100},  //AuxLight
+	{FLOAT2Q16(3 * INCH2CM * 10), 0, 600}             //MainLight, 3 in ahead of the axle
+};
+
+//Distance to the wall from the sonar and myBot together
+WallFilterClass WallFilter(&myBot);
+
+//Limits and profile for drive moves, and where the current move started
+const ProfileClass::Limits DriveLimits = {INT2Q16(PROFILE_VEL), INT2Q16(PROFILE_ACCEL), INT2Q16(PROFILE_JERK)};
+ProfileClass DriveProfile(DriveLimits);
+RobotClass::RectData DriveOrigin;
+
+//Set when a straight ends at speed, for the next move to carry on from, and how
+//far past its end the profile was by then
+bool DriveHandOver = false;
+Q16 DriveCarry = 0;
+
+//Limits for the wall approach, which has the sonar to stop it
+const ProfileClass::Limits WallLimits = {INT2Q16(WALL_VEL), INT2Q16(WALL_ACCEL), INT2Q16(WALL_JERK)};
+
+//Limits and profile for turns in place, in degrees
+const ProfileClass::Limits TurnLimits = {INT2Q16(TURN_VEL), INT2Q16(TURN_ACCEL), INT2Q16(TURN_JERK)};
+const ProfileClass::Limits SearchLimits = {INT2Q16(TURN_SEARCH_VEL), INT2Q16(TURN_ACCEL), INT2Q16(TURN_JERK)};
+ProfileClass TurnProfile(TurnLimits);
+
+//Steers along a path from myBot's pose
+PursuitClass Pursuit(&myBot);
+
+//Snaps myBot to the lines as they are crossed
+LandmarkClass Landmarks(&myBot, CourseLines, NUM_COURSE_LINES,
+						LineSensors, sizeof(LineSensors) / sizeof(LineSensors[0]));
+
 TaskShare<U8> task_NavState;
 
+TaskShare<U8> task_NavGoal;
+
+//Place on the course the robot last got to, where the next route starts
+U8 NavPlace = PLACE_START;
+
+//Moves waiting to run, and how many have finished
+TaskQueue<NavMove> NavQueue;
+TaskShare<U16> NavMovesDone;
+U16 NavCompleted = 0;
+
+//Nav state being run, the command it was started from, and whether it has been
+//stepped yet. The command is NAV_IDLE when nothing is running.
+U8 NavRow = NAV_IDLE;
+U8 NavCommand = NAV_IDLE;
+bool NavFirst = true;
+
+//Argument of the state being run, from its NavMove or task_NavGoal
+S16 NavArg = 0;
+
+ecrobot::Speaker mSpeak;
+
+TaskShare<S32> TicksPerTurn;
 
 
 /**************************************************************************************
- * Go Straight Method
+ * Share Geometry
  **************************************************************************************/
-/** @brief   Simple controller to send the motors straight
- *  @details Keeps the motors moving straight
+/** @brief   Let the other tasks know the wheel geometry in @c myBot
+ *  @details Sets @c TicksPerTurn for the turn routines and @c MmPerTick for the
+ * 			 drive task.
  */
 
-void goStraight(S8 power, bool reset = false)
+void shareGeometry(void)
 {
-	//static RobotClass::RectData pos;
-	S32 Rpow;
-	S32 Lpow;
-	S32 Rcount;
-	S32 Lcount;
-	S32 RLerror;
-	S32 deltaP;
-	static S32 RLerror_sum = 0;
+	Q16 rad;
+	Q16 base;
 	
-	if (reset) 
+	myBot.GetGeometry(rad, base);
+	
+	TicksPerTurn.put(myBot.GetTurnTicks());
+	MmPerTick.put(Q16mul(rad, Q16_TWO_PI) / 360);
+}
+
+
+/**************************************************************************************
+ * Share Wheel Speeds
+ **************************************************************************************/
+/** @brief   Let the drive task know how fast the wheels are going
+ *  @details Puts the filtered speeds from @c myBot in @c MeasuredSpeeds for the
+ * 			 wheel loops. Call it after each @c myBot.Update().
+ */
+
+void shareWheelSpeeds(void)
+{
+	WheelRates speeds;
+	
+	myBot.GetWheelSpeeds(speeds.left, speeds.right);
+	MeasuredSpeeds.put(speeds);
+}
+
+
+/**************************************************************************************
+ * Odometry Sample
+ **************************************************************************************/
+/** @brief   Take an encoder sample for the robot object
+ *  @details Called from the 1 ms interrupt in task_MasterInit.cpp, so the samples
+ * 			 are evenly spaced no matter how busy the tasks are. @c NavRun()
+ * 			 integrates them with @c myBot.Update().
+ */
+
+void OdometrySample(void)
+{
+	myBot.Sample();
+}
+
+
+
+/**************************************************************************************
+ * Check Landmarks
+ **************************************************************************************/
+/** @brief   Correct the odometry if a light sensor just crossed a line
+ *  @details MainLight is only watched while the line follower isn't using it,
+ * 			 since following the edge of a line crosses it all the time. The
+ * 			 residual of each correction is shown on the debug line.
+ *  @param   tick When the sensors are read
+ */
+
+void checkLandmarks(U32 tick)
+{
+	LandmarkClass::Residual res;
+	bool snapped;
+	
+	snapped = Landmarks.Check(SENSOR_AUX, AuxLight.getBrightness(), tick);
+	
+	if (task_LFStart.get())
+	{
+		Landmarks.Ignore(SENSOR_MAIN);
+	}
+	else
 	{
-		RLerror_sum = 0;
+		snapped |= Landmarks.Check(SENSOR_MAIN, MainLight.getBrightness(), tick);
 	}
 	
-	Rcount = RightWheel.getCount();
-	Lcount = LeftWheel.getCount();
+	if (snapped && Landmarks.GetResidual(0, res) && !StatsPageOn.get())
+	{
+		Display.cursor(0,DEBUG);
+		Display.putf("sdsd\n", "Fix ", res.line, 0, " mm ", Q16round(res.error), 0);
+		Display.disp();
+	}
+}
+
+
+/**************************************************************************************
+ * Track Wall
+ **************************************************************************************/
+/** @brief   Update the wall distance estimate
+ *  @details Takes the latest reading from the sonar task, so it never waits on
+ * 			 the sonar. A reading is only used once, and not at all if it is older
+ * 			 than @c SONAR_STALE ms. Without new readings the estimate is carried
+ * 			 on by odometry alone and its sigma grows. Starts the filter over when
+ * 			 @c start is set. The filter only starts from a fresh reading with an
+ * 			 echo, not the placeholder the sonar task puts before its first one,
+ * 			 so until one comes in there is no estimate.
+ *  @param   tick     Current time
+ *  @param   start    True on the first call for a new wall
+ *  @param   distance The estimated distance from the sonar to the wall, Q16 mm
+ *  @return  False while there is no estimate yet
+ */
+
+bool trackWall(U32 tick, bool start, Q16& distance)
+{
+	static U16 lastCount = 0;
+	static bool tracking = false;
+	SonarReading reading = SonarData.get();
+	U32 age = tick - reading.tick;
+	bool fresh = (reading.count != 0 && age < SONAR_STALE);
 	
-	RLerror = Rcount - (Lcount);
-	RLerror_sum += RLerror;
+	if (start) {tracking = false;}
 	
-	deltaP = Kp_STRAIGHT* RLerror + Ki_STRAIGHT * RLerror_sum / 1024;
+	if (!tracking)
+	{
+		tracking = fresh && WallFilter.Start(reading.cm, reading.tick);
+	}
+	else
+	{
+		WallFilter.Predict();
+		
+		if (fresh && reading.count != lastCount)
+		{
+			WallFilter.Measure(reading.cm, reading.tick);
+		}
+	}
 	
-	if (deltaP > MAX_DELTA) {deltaP = MAX_DELTA;}
-	if (deltaP < MIN_DELTA) {deltaP = MIN_DELTA;}
+	lastCount = reading.count;
 	
-	if (power > 0)
+	if (!StatsPageOn.get())
 	{
-		Rpow = power - deltaP;
-		Lpow = power + deltaP;
+		Display.cursor(0,NAV_LINE);
+		if (tracking)
+		{
+			Display.putf("sdsdsd\n", "Wall ", Q16round(WallFilter.GetDistance()), 0, " +-", Q16round(WallFilter.GetSigma()), 0, " ", age, 0);
+		}
+		else
+		{
+			Display.putf("sd\n", "Wall wait ", reading.cm, 0);
+		}
+		Display.disp();
 	}
-	if (power < 0)
+	
+	distance = WallFilter.GetDistance();
+	return tracking;
+}
+
+
+/**************************************************************************************
+ * Hold Heading Method
+ **************************************************************************************/
+/** @brief   Drive along a heading
+ *  @details A PID controller on the heading from @c myBot, which steers by
+ * 			 adding speed to one wheel and taking it from the other. The
+ * 			 derivative term uses the measured turn rate, so a step in the
+ * 			 commanded heading doesn't kick the motors. The integral stops
+ * 			 growing while the steering is at its limit. Steering the same
+ * 			 way works going forwards or backwards, so @c speed can be either
+ * 			 sign. Nothing here touches the encoders.
+ * 
+ * 			 Call it once per nav cycle, after @c myBot.Update(). Changing
+ * 			 @c heading a little each cycle drives a curve.
+ *  @param   speed   Speed for both wheels before steering, mm/s
+ *  @param   heading Heading to hold, as a binary angle
+ *  @param   reset   True to clear the integral, when starting a new move
+ */
+
+void holdHeading(S16 speed, U32 heading, bool reset = false)
+{
+	static Q16 errorSum = 0;
+	RobotClass::RectData pos = myBot.GetInfo();
+	Q16 error;
+	Q16 rate;
+	Q16 steer;
+	S32 deltaV;
+	S32 Rspeed;
+	S32 Lspeed;
+	
+	if (reset)
 	{
-		Rpow = power + deltaP;
-		Lpow = power - deltaP;
+		errorSum = 0;
 	}
 	
-	RightWheel.setPWM((S8) Rpow);
-	LeftWheel.setPWM((S8) Lpow);
+	//Heading error in degrees, the short way round, and the turn rate in degrees/s
+	error = Bam2DegQ16(heading - pos.theta);
+	rate = Q16mul(pos.thetadot, FLOAT2Q16(180 / 3.14159265));
+	
+	steer = Q16mul(HEADING_KP, error) + Q16mul(HEADING_KI, errorSum) - Q16mul(HEADING_KD, rate);
+	deltaV = Q16round(steer);
+	
+	if (deltaV > HEADING_MAX_DELTA) {deltaV = HEADING_MAX_DELTA;}
+	else if (deltaV < -HEADING_MAX_DELTA) {deltaV = -HEADING_MAX_DELTA;}
+	else {errorSum += error * NAV_PERIOD / 1000;}
 	
-// 	Display.cursor(0,DEBUG);
-// 	Display.putf("sd\n", "Rpow: ", Rpow,0);
-// 	Display.putf("sd\n", "Lpow: ", Lpow,0);
-// 	Display.putf("sd\n", "RLerror: ", RLerror,0);
-// 	Display.putf("sd\n", "RLerror_sum: ", RLerror_sum,0);
-// 	Display.disp();
+	Rspeed = speed + deltaV;
+	Lspeed = speed - deltaV;
 	
+	if (Rspeed > MAX_WHEEL_SPEED) {Rspeed = MAX_WHEEL_SPEED;}
+	if (Rspeed < -MAX_WHEEL_SPEED) {Rspeed = -MAX_WHEEL_SPEED;}
+	if (Lspeed > MAX_WHEEL_SPEED) {Lspeed = MAX_WHEEL_SPEED;}
+	if (Lspeed < -MAX_WHEEL_SPEED) {Lspeed = -MAX_WHEEL_SPEED;}
+	
+	setWheelSpeeds((S16) Lspeed, (S16) Rspeed);
 }
 
 
 /**************************************************************************************
- * Task Nav Constructor
+ * Go Straight Method
  **************************************************************************************/
-/** @brief   Constructor for the navigation task
- *  @details 
- *  
+/** @brief   Simple controller to send the motors straight
+ *  @details Holds the heading the robot had when it was last reset.
+ *  @param   speed Speed for both wheels, mm/s
+ *  @param   reset True to take the current heading as the one to hold
+ */
+
+void goStraight(S16 speed, bool reset = false)
+{
+	static U32 heading = 0;
+	
+	if (reset) 
+	{
+		heading = myBot.GetInfo().theta;
+	}
+	
+	holdHeading(speed, heading, reset);
+}
+
+
+/**************************************************************************************
+ * Start Drive
+ **************************************************************************************/
+/** @brief   Start a new profiled drive move from where the robot is
+ *  @details Takes the current pose as the start of the move and the heading to
+ * 			 hold, and stops the wheels until @c profileDrive() is called.
  */
 
+void startDrive(void)
+{
+	DriveOrigin = myBot.GetInfo();
+	DriveHandOver = false;
+	DriveCarry = 0;
+	DriveProfile.Reset();
+	DriveProfile.SetLimits(DriveLimits);
+	DriveProfile.Start(0);
+	
+	holdHeading(0, DriveOrigin.theta, true);
+}
 
-void NavConstructor(void)
+
+/**************************************************************************************
+ * Continue Drive
+ **************************************************************************************/
+/** @brief   Start a drive move from where the last one is, at the speed it has
+ *  @details If a straight handed over to this move at speed (@c DriveHandOver),
+ * 			 the new move starts where the profile is rather than where the
+ * 			 robot is, so the robot stays just as far behind it, and keeps the
+ * 			 heading it was holding. Otherwise this is @c startDrive().
+ */
+
+void continueDrive(void)
 {
+	Q16 pos = DriveProfile.GetPos();
 	
-	task_NavState.put(NAV_IDLE);
+	if (!DriveHandOver)
+	{
+		startDrive();
+		return;
+	}
 	
-	Display.cursor(0,NAV_LINE);
-	Display.putf("s\n", "Nav Ready");
-	Display.disp();
+	DriveHandOver = false;
 	
+	DriveOrigin.x += Q16mul(pos, CosQ16(DriveOrigin.theta));
+	DriveOrigin.y += Q16mul(pos, SinQ16(DriveOrigin.theta));
+	
+	DriveProfile.SetLimits(DriveLimits);
+	DriveProfile.Start(0);
 }
 
 
+/**************************************************************************************
+ * Drive Traveled
+ **************************************************************************************/
+/** @brief   How far the robot has gone along the heading it started the move on
+ *  @return  Distance in Q16 mm, negative if it went backwards
+ */
+
+Q16 driveTraveled(void)
+{
+	RobotClass::RectData pos = myBot.GetInfo();
+	
+	return Q16mul(pos.x - DriveOrigin.x, CosQ16(DriveOrigin.theta)) + 
+		   Q16mul(pos.y - DriveOrigin.y, SinQ16(DriveOrigin.theta));
+}
+
 
 /**************************************************************************************
- * Task Nav Run Method (infinite loop)
+ * Profile Drive
  **************************************************************************************/
-/** @brief   Run method for the navigation task
- *  @details 
+/** @brief   Drive straight along a jerk limited profile
+ *  @details Moves the profile on one nav cycle, then asks for its speed plus
+ * 			 a correction for how far the robot is behind it. The heading is
+ * 			 held at the one the move started on.
  * 
+ * 			 The target can change every call, so a move to a sensed distance
+ * 			 just passes the latest estimate and the profile bends to suit.
+ * 			 Call @c startDrive() first, and once per nav cycle after
+ * 			 @c myBot.Update().
+ *  @param   target Where to stop, Q16 mm along the starting heading from the
+ * 			 start of the move, negative to back up
+ *  @return  True once the profile has reached the target and stopped
  */
 
+bool profileDrive(Q16 target)
+{
+	S32 speed;
+	bool done;
+	
+	DriveProfile.SetTarget(target);
+	done = DriveProfile.Step(NAV_PERIOD);
+	
+	speed = Q16round(DriveProfile.GetVel() + Q16mul(DRIVE_KP, DriveProfile.GetPos() - driveTraveled()));
+	
+	if (speed > MAX_WHEEL_SPEED) {speed = MAX_WHEEL_SPEED;}
+	if (speed < -MAX_WHEEL_SPEED) {speed = -MAX_WHEEL_SPEED;}
+	
+	holdHeading((S16) speed, DriveOrigin.theta);
+	
+	return done;
+}
+
 
-void NavRun(void)
+/**************************************************************************************
+ * Wall Target
+ **************************************************************************************/
+/** @brief   Where a wall move should aim for
+ *  @details The profile brakes in time for the target it has, but the wall
+ * 			 estimate can still move by a few sigma when the next reading comes
+ * 			 in. So the target is pulled in by up to @c BRAKE_SIGMAS sigma, in
+ * 			 proportion to the speed. At speed a late correction can only make
+ * 			 the move longer, never too short to stop in. As the robot slows the
+ * 			 margin goes away, and it ends on the estimate itself.
+ *  @param   toGo Distance left to the stop, Q16 mm, negative to back up
+ *  @return  Target for @c profileDrive()
+ */
+
+Q16 wallTarget(Q16 toGo)
 {
-	U32 currentTime;
-	S16 curDist;
-	//RobotClass::RectData curPos;
-	//bool StopLF = false;
-	//bool LineDetected = false;
-	//S32 LinePos;
-	U8 stage = 0;
-	bool firstPass = true;
-	S8 power;
-	S16 error;
-	S16 error_sum;
-	U8 at_Wall;
-	U8 loop_count=0;
-	
-	ecrobot::Speaker mSpeak;
+	Q16 vel = DriveProfile.GetVel();
+	Q16 margin;
 	
-	//Go forever!
-	while(true)
-	{		
-		currentTime = NNxt::getTick();		
+	if (vel < 0) {vel = -vel;}
+	if (vel > INT2Q16(WALL_VEL)) {vel = INT2Q16(WALL_VEL);}
+	
+	margin = BRAKE_SIGMAS * Q16mul(WallFilter.GetSigma(), Q16div(vel, INT2Q16(WALL_VEL)));
+	
+	if (toGo > 0)
+	{
+		if (margin > toGo) {margin = toGo;}
 		
-		switch (task_NavState.get())
-		{			
-			case NAV_IDLE:
-					
-				firstPass = true;
-				task_NavDone.put(false);
-				
-				break;
-			
-			case NAV_TO_SUPPLY:
+		return driveTraveled() + toGo - margin;
+	}
+	
+	if (margin > -toGo) {margin = -toGo;}
+	
+	return driveTraveled() + toGo + margin;
+}
+
+
+/**************************************************************************************
+ * Stop Target
+ **************************************************************************************/
+/** @brief   Where the profile can stop from the speed it has
+ *  @details Used by the wall moves while there is no wall estimate to aim at,
+ * 			 so the robot comes to rest instead of driving on blind. The jerk
+ * 			 adds about @c vel*accel/(2*jerk) to the braking distance.
+ *  @return  The target in the same units as @c profileDrive()
+ */
+
+Q16 stopTarget(void)
+{
+	Q16 vel = DriveProfile.GetVel();
+	Q16 stop;
+	
+	if (vel < 0) {vel = -vel;}
+	
+	stop = (Q16mul(Q16div(vel, WallLimits.accel), vel) + Q16mul(vel, Q16div(WallLimits.accel, WallLimits.jerk))) / 2;
+	
+	return DriveProfile.GetPos() + ((DriveProfile.GetVel() < 0) ? -stop : stop);
+}
+
+
+/**************************************************************************************
+ * Follow Path
+ **************************************************************************************/
+/** @brief   Drive along the path given to @c Pursuit
+ *  @details The drive profile sets the speed, aimed at the distance still to go
+ * 			 along the path each cycle, so the robot speeds up and slows down
+ * 			 smoothly. Its top speed is held to the limit of the segment being
+ * 			 followed. @c Pursuit splits that speed between the wheels to stay
+ * 			 on the path. Call @c startDrive() and @c Pursuit.Start() first, and
+ * 			 this once per nav cycle after @c myBot.Update().
+ *  @return  True once the robot is at the last waypoint, with the wheels stopped
+ */
+
+bool followPath(void)
+{
+	ProfileClass::Limits limits = DriveLimits;
+	Q16 left;
+	Q16 right;
+	bool done;
+	
+	if (Pursuit.GetSpeedLimit() > 0 && INT2Q16(Pursuit.GetSpeedLimit()) < limits.vel)
+	{
+		limits.vel = INT2Q16(Pursuit.GetSpeedLimit());
+	}
+	
+	DriveProfile.SetLimits(limits);
+	DriveProfile.SetTarget(DriveProfile.GetPos() + Pursuit.GetRemaining());
+	DriveProfile.Step(NAV_PERIOD);
+	
+	done = Pursuit.Steer(DriveProfile.GetVel(), left, right);
+	
+	setWheelSpeeds((S16) Q16round(left), (S16) Q16round(right));
+	
+	return done;
+}
+
+
+/**************************************************************************************
+ * Line Edge
+ **************************************************************************************/
+/** @brief   Watch a light sensor for the step from the floor onto a line
+ *  @param   brightness What the sensor read
+ *  @param   threshold  Brightness above this is a line
+ *  @param   onLine     The sensor's state, kept by the caller
+ *  @return  True on the reading where the sensor reached a line
+ */
+
+bool lineEdge(S16 brightness, S16 threshold, bool& onLine)
+{
+	if (!onLine && brightness > threshold)
+	{
+		onLine = true;
+		return true;
+	}
+	
+	if (onLine && brightness < threshold - LandmarkClass::LINE_HYSTERESIS)
+	{
+		onLine = false;
+	}
+	
+	return false;
+}
+
+
+/**************************************************************************************
+ * Calibrate
+ **************************************************************************************/
+/** @brief   Measure the wheel radius and wheel base on the field
+ *  @details Set the robot down square to, and just behind, the first two lines
+ * 			 in @c CourseLines. It runs in three stages:
+ * 			 \li Drive straight until AuxLight has crossed both lines. The ticks
+ * 				 between the crossings over the known spacing give the radius.
+ * 			 \li Spin in place over the second line. MainLight crosses it twice
+ * 				 a turn, at the same two places every turn, so @c CAL_TURNS
+ * 				 turns are exactly twice that many crossings. The ticks over
+ * 				 that angle, with the new radius, give the wheel base.
+ * 			 \li Hand the results to @c myBot and @c TicksPerTurn and show them.
+ * 			 Each crossing happened somewhere between two readings, so the
+ * 			 counts halfway between them are used.
+ *  @param   start True on the first call
+ *  @return  True once it is done
+ */
+
+bool calibrate(bool start)
+{
+	static U8 stage;
+	static U8 crossings;
+	static bool onLine;
+	static S32 lastL;
+	static S32 lastR;
+	static S32 firstL;
+	static S32 firstR;
+	S32 curL = LeftWheel.getCount();
+	S32 curR = RightWheel.getCount();
+	S32 ticks;
+	Q16 rad;
+	Q16 base;
+	
+	if (start)
+	{
+		stage = 0;
+		crossings = 0;
+		onLine = true;
+		goStraight(0, true);
+		lastL = curL;
+		lastR = curR;
+	}
+	
+	switch (stage)
+	{
+		//Straight run across both lines
+		case 0:
 			
+			goStraight(CAL_SPEED);
 			
-				switch (stage)
+			if (lineEdge(AuxLight.getBrightness(), LineSensors[SENSOR_AUX].threshold, onLine))
+			{
+				if (crossings == 0)
+				{
+					firstL = (lastL + curL) / 2;
+					firstR = (lastR + curR) / 2;
+					crossings = 1;
+				}
+				else
 				{
-					//Follow line until the center line is seen
-					case 0:
-						
-						task_LFStart.put(true);
-						
-						Display.cursor(0,NAV_LINE);
-						Display.putf("sd\n", "Color: ", (U8) AuxLight.getBrightness(),0);
-						Display.disp();
-						
-						if((U8) AuxLight.getBrightness() > 100 ) 
-						{
-							//Go to next stage
-							stage = 1;	
-							task_LFStart.put(false);
-							
-						}
+					ticks = ((lastL + curL) / 2 - firstL + (lastR + curR) / 2 - firstR) / 2;
 					
-						break;
+					//Spacing = 2 pi r / 360 * ticks
+					myBot.GetGeometry(rad, base);
+					rad = (Q16) (((S64) (CourseLines[1].pos - CourseLines[0].pos) * 360 << Q16_SHIFT) / ((S64) Q16_TWO_PI * ticks));
+					myBot.SetGeometry(rad, base);
 					
-					//Move past center line
-					case 1:
-						goStraight(50);
-						
-						loop_count++;
-						
-						if (loop_count > NUM_LOOPS)
-						{
-							stage = 2;
-						}
+					setWheelSpeeds(0, 0);
 					
-						break;
-						
-					//Follow line supply line
-					case 2:
-						task_LFStart.put(true);
-						
-						if((U8) AuxLight.getBrightness() > 100 ) 
-						{
-							//Go to next stage
-							stage = 0;	
-							task_LFStart.put(false);
-							task_NavState.put(IDLE);
-							
-						}
-						break;
+					onLine = true;
+					crossings = 0;
+					stage = 1;
 				}
+			}
 			
-				
-				
-				//Find line - drive along
-				//When getting close to center, switch to manual control
-				//Resume LF until getting close to wall
-				
-				break;
-			
-				
-			case NAV_TO_SCORE:
-			
-			
-			
-				break;
-				
-				
-			case NAV_APPROACH_WALL:
-				
-// 				if(firstPass == true)
-// 				{
-// 					error = 0;
-// 					error_sum = 0;
-// 					at_Wall = 0;
-// 					RightWheel.reset();
-// 					LeftWheel.reset();
-// 					goStraight(0, true);
-// 					firstPass = false;
-// 				}
-// 				
-// 				//Distance from wall in cm
-// 				curDist = Sonar.getDistance(); 
-// 				
-// 				//Calculate errors in cm
-// 				error = (curDist - DIST_FROM_WALL * INCH2CM);				
-// 				error_sum += error;
-// 				
-// 				if (error <= 0) {at_Wall++;}
-// 				else {at_Wall = 0;}
-// 				
-// 				power = (S8) (Kp * error + Ki * error_sum / 1024);
-// 				
-// 				if (power < MIN_POWER) {power = MIN_POWER;}
-// 				
-// 				goStraight(power);
-// 			
-// 				if (at_Wall > LONG_ENOUGH)
-// 				{
-// 					task_NavState.put(NAV_IDLE);
-// 					RightWheel.setPWM(0);
-// 					LeftWheel.setPWM(0);
-// 
-// 					mSpeak.playTone(500,50,20);					
-// 				}
-// 				
-// 				Display.cursor(0,NAV_LINE);
-// 				Display.putf("sd\n", "curDist: ", curDist,0);
-// 				Display.putf("sd\n", "error: ", error,0);
-// 				Display.putf("sd\n", "error_sum: ", error_sum,0);
-// 				Display.disp();
-				
-				//Take over when close to wall
-				//Drive forward using US
-				//Goal is to stop at proper position underneath rings
+			break;
+		
+		//Spin over the second line
+		case 1:
 			
-				if(firstPass == true)
-				{
-					error = 0;
-					error_sum = 0;
-					at_Wall = 0;
-					RightWheel.reset();
-					LeftWheel.reset();
-					goStraight(0, true);
-					firstPass = false;
-				}
-				
-				//Distance from wall in cm
-				curDist = Sonar.getDistance(); 
-				
-				//Calculate errors in cm
-				error =  curDist - DIST_FROM_WALL * INCH2CM;				
-				
-				goStraight(FORWARD_SPEED);
+			setWheelSpeeds(-CAL_SPEED, CAL_SPEED);
 			
-				if (error <= 0)
+			if (lineEdge(MainLight.getBrightness(), LineSensors[SENSOR_MAIN].threshold, onLine))
+			{
+				if (crossings == 0)
 				{
-					task_NavState.put(NAV_IDLE);
-					RightWheel.setPWM(0);
-					LeftWheel.setPWM(0);
-
-					mSpeak.playTone(500,50,20);					
+					firstL = (lastL + curL) / 2;
+					firstR = (lastR + curR) / 2;
 				}
 				
-				
-				break;
-				
-			case NAV_BACK_UP:
-				
-				if(firstPass == true)
+				if (crossings == 2 * CAL_TURNS)
 				{
-					error = 0;
-					error_sum = 0;
-					at_Wall = 0;
-					RightWheel.reset();
-					LeftWheel.reset();
-					goStraight(0, true);
-					firstPass = false;
+					setWheelSpeeds(0, 0);
+					
+					ticks = (lastR + curR) / 2 - firstR - ((lastL + curL) / 2 - firstL);
+					
+					//Each wheel turned 180 * base / r ticks per spin, see RobotClass::GetTurnTicks()
+					myBot.GetGeometry(rad, base);
+					base = (Q16) ((S64) ticks * rad / (360 * CAL_TURNS));
+					myBot.SetGeometry(rad, base);
+					
+					stage = 2;
 				}
 				
-				//Distance from wall in cm
-				curDist = Sonar.getDistance(); 
-				
-				//Calculate errors in cm
-				error =  BACK_DIST * INCH2CM - curDist;				
-				
-				goStraight(BACKUP_SPEED);
+				crossings++;
+			}
 			
-				if (error <= 0)
-				{
-					task_NavState.put(NAV_IDLE);
-					RightWheel.setPWM(0);
-					LeftWheel.setPWM(0);
-
-					mSpeak.playTone(500,50,20);					
-				}
-				
-				
-				//Carefully back up away from rings to certain distance
-				//Using US 
-				
-				break;
-				
-			case NAV_TURN_AROUND:
+			break;
+		
+		//Share and show the results
+		case 2:
 			
-				//Turn in place, (using encoders?), until line is acquired
-				
-				break;
-				
-		}//End switch
+			shareGeometry();
+			
+			myBot.GetGeometry(rad, base);
+			
+			if (!StatsPageOn.get())
+			{
+				Display.cursor(0,NAV_LINE);
+				Display.putf("sdsd\n", "R um ", (S32) ((S64) rad * 1000 >> Q16_SHIFT), 0, " B ", (S32) ((S64) base * 1000 >> Q16_SHIFT), 0);
+				Display.disp();
+			}
+			
+			return true;
+	}
+	
+	lastL = curL;
+	lastR = curR;
+	
+	return false;
+}
+
+
+/**************************************************************************************
+ * Profile Turn
+ **************************************************************************************/
+/** @brief   Turn in place along a jerk limited profile, and stop on a line
+ *  @details The angle turned is added up from the change in the odometry
+ * 			 heading each cycle, so a turn of 180 degrees or more is no
+ * 			 problem. The turn rate asked for is the profile's plus a
+ * 			 correction for how far the robot is behind it.
+ * 
+ * 			 When looking for a line, MainLight is watched over the last
+ * 			 @c TURN_SEARCH degrees. The moment it reaches the line, the end of
+ * 			 the turn is moved to half a line width further on, so the robot
+ * 			 stops with the sensor over the middle of it. If the turn ends
+ * 			 without seeing a line it carries on slowly, up to @c TURN_SEARCH
+ * 			 degrees more, before giving up.
+ * 
+ * 			 Call once per nav cycle after @c myBot.Update().
+ *  @param   degrees  How far to turn, positive turns left
+ *  @param   start    True on the first call of a turn
+ *  @param   seekLine True to stop on the line near the end of the turn
+ *  @return  True once the turn is done, with the wheels stopped
+ */
+
+bool profileTurn(Q16 degrees, bool start, bool seekLine)
+{
+	static Q16 turned;
+	static U32 lastTheta;
+	static Q16 target;
+	static bool onLine;
+	static bool found;
+	static bool extended;
+	RobotClass::RectData pos = myBot.GetInfo();
+	S8 dir = (degrees >= 0) ? 1 : -1;
+	Q16 toGo;
+	Q16 rate;
+	Q16 rad;
+	Q16 base;
+	S32 speed;
+	bool edge;
+	
+	if (start)
+	{
+		turned = 0;
+		lastTheta = pos.theta;
+		target = degrees;
+		onLine = true;
+		found = false;
+		extended = false;
+		
+		TurnProfile.Reset();
+		TurnProfile.SetLimits(TurnLimits);
+		TurnProfile.Start(degrees);
+	}
+	
+	turned += Bam2DegQ16(pos.theta - lastTheta);
+	lastTheta = pos.theta;
+	
+	//Watch every cycle so the line state is right, but only take a line near the end
+	edge = lineEdge(MainLight.getBrightness(), LineSensors[SENSOR_MAIN].threshold, onLine);
+	toGo = (target - turned) * dir;
+	
+	if (seekLine && !found && edge && toGo < INT2Q16(TURN_SEARCH))
+	{
+		found = true;
+		target = turned + dir * LINE_HALF_ANGLE;
+		TurnProfile.SetTarget(target);
+	}
+	
+	if (TurnProfile.Step(NAV_PERIOD))
+	{
+		if (seekLine && !found && !extended)
+		{
+			extended = true;
+			target += dir * INT2Q16(TURN_SEARCH);
+			TurnProfile.SetLimits(SearchLimits);
+			TurnProfile.SetTarget(target);
+		}
+		else
+		{
+			setWheelSpeeds(0, 0);
+			
+			if (seekLine && !found && !StatsPageOn.get())
+			{
+				Display.cursor(0,NAV_LINE);
+				Display.putf("s\n", "No line");
+				Display.disp();
+			}
+			
+			return true;
+		}
+	}
+	
+	//Turn rate in degrees/s, then each wheel's speed: rate * pi / 180 * base / 2
+	rate = TurnProfile.GetVel() + Q16mul(TURN_KP, TurnProfile.GetPos() - turned);
+	
+	myBot.GetGeometry(rad, base);
+	speed = Q16round(Q16mul(Q16mul(rate, FLOAT2Q16(3.14159265 / 180)), base / 2));
+	
+	if (speed > MAX_WHEEL_SPEED) {speed = MAX_WHEEL_SPEED;}
+	if (speed < -MAX_WHEEL_SPEED) {speed = -MAX_WHEEL_SPEED;}
+	
+	setWheelSpeeds((S16) -speed, (S16) speed);
+	
+	return false;
+}
+
+
+/**************************************************************************************
+ * Navigation Behaviors
+ **************************************************************************************/
+//Each nav state is a row of NavTable below, made of these functions. An enter
+//function sets the state up and returns false if it can't run. A step function
+//runs once a cycle and returns true when the state is done. An exit function
+//runs when it is done, before the next state is entered.
+
+
+//Nothing to do
+bool stepIdle(U32 tick, bool first)
+{
+	(void) tick;
+	(void) first;
+	
+	return false;
+}
+
+
+//Follow the line until the aux light sees a cross line
+bool stepToLine(U32 tick, bool first)
+{
+	U8 brightness = (U8) AuxLight.getBrightness();
+	
+	(void) tick;
+	(void) first;
+	
+	task_LFStart.put(true);
+	
+	if (!StatsPageOn.get())
+	{
+		Display.cursor(0,NAV_LINE);
+		Display.putf("sd\n", "Color: ", brightness,0);
+		Display.disp();
+	}
+	
+	return brightness > 100;
+}
+
+//Stop following at a cross line
+void exitCenterLine(void)
+{
+	task_LFStart.put(false);
+}
+
+//Stop following at the supply line, which is the supply
+void exitSupplyLine(void)
+{
+	task_LFStart.put(false);
+	NavPlace = PLACE_SUPPLY;
+}
+
+
+//Drive across the center line, line following can't
+bool enterCross(U32 tick)
+{
+	(void) tick;
+	
+	startDrive();
+	return true;
+}
+
+bool stepCross(U32 tick, bool first)
+{
+	(void) tick;
+	(void) first;
+	
+	return profileDrive(INT2Q16(CENTER_CROSS_DIST));
+}
+
+
+//Follow the course route from where the robot is to the goal
+U8 RouteGoal;
+
+bool enterRoute(U32 tick)
+{
+	const CourseRoute* p_Route;
+	
+	(void) tick;
+	
+	RouteGoal = (NavCommand == NAV_TO_SCORE) ? (U8) PLACE_SCORE : (U8) NavArg;
+	p_Route = findRoute(NavPlace, RouteGoal);
+	
+	if (p_Route == 0)
+	{
+		if (!StatsPageOn.get())
+		{
+			Display.cursor(0,NAV_LINE);
+			Display.putf("sdsd\n", "No route ", NavPlace, 0, "-", RouteGoal, 0);
+			Display.disp();
+		}
+		
+		return false;
+	}
+	
+	continueDrive();
+	Pursuit.Start(p_Route -> p_Path, p_Route -> count);
+	
+	return true;
+}
+
+bool stepRoute(U32 tick, bool first)
+{
+	(void) tick;
+	(void) first;
+	
+	return followPath();
+}
+
+void exitRoute(void)
+{
+	NavPlace = RouteGoal;
+	mSpeak.playTone(500,50,20);
+}
+
+
+//Drive up to the wall with the sonar, to stop underneath the rings. Until the
+//sonar has a good reading the robot stops and waits for one
+bool enterApproachWall(U32 tick)
+{
+	Q16 wall;
+	
+	continueDrive();
+	DriveProfile.SetLimits(WallLimits);
+	trackWall(tick, true, wall);
+	
+	return true;
+}
+
+bool stepApproachWall(U32 tick, bool first)
+{
+	Q16 wall;
+	Q16 toGo;
+	
+	(void) first;
+	
+	if (!trackWall(tick, false, wall))
+	{
+		profileDrive(stopTarget());
+		return false;
+	}
+	
+	//Distance left to the stop in mm
+	toGo = wall - CourseWalls[CoursePlaces[NavPlace].wall].stopDist;
+	
+	//Aim the profile at the latest estimate of the stop
+	return profileDrive(wallTarget(toGo)) || toGo <= 0;
+}
+
+
+//Carefully back away from the rings with the sonar, once it has a good reading
+bool enterBackUp(U32 tick)
+{
+	Q16 wall;
+	
+	startDrive();
+	trackWall(tick, true, wall);
+	
+	return true;
+}
+
+bool stepBackUp(U32 tick, bool first)
+{
+	Q16 wall;
+	Q16 toGo;
+	
+	(void) first;
+	
+	if (!trackWall(tick, false, wall))
+	{
+		profileDrive(stopTarget());
+		return false;
+	}
+	
+	//Distance left to the stop in mm
+	toGo = CourseWalls[CoursePlaces[NavPlace].wall].backDist - wall;
+	
+	return profileDrive(wallTarget(-toGo)) || toGo <= 0;
+}
+
+
+//Drive straight NavArg mm from where the robot is, or from the end of the
+//straight before it when it carries on from one
+Q16 StraightDist;
+
+bool enterStraight(U32 tick)
+{
+	(void) tick;
+	
+	continueDrive();
+	StraightDist = INT2Q16(NavArg) - DriveCarry;
+	
+	return true;
+}
+
+//How far past the end of a straight to plan, to drive on into the next move
+Q16 blendAhead(void)
+{
+	NavMove next;
+	
+	if (!NavQueue.peek(next)) {return 0;}
+	
+	switch (next.state)
+	{
+		//Another straight the same way, plan for the whole of it
+		case NAV_STRAIGHT:
+			
+			if ((next.arg > 0) == (NavArg > 0)) {return INT2Q16(next.arg);}
+			break;
+			
+		//These brake for themselves
+		case NAV_APPROACH_WALL:
+		case NAV_TO_SCORE:
+		case NAV_ROUTE:
+			
+			if (NavArg > 0) {return INT2Q16(NAV_BLEND_DIST);}
+			break;
+	}
+	
+	return 0;
+}
+
+bool stepStraight(U32 tick, bool first)
+{
+	Q16 dist = StraightDist;
+	Q16 ahead = blendAhead();
+	
+	(void) tick;
+	(void) first;
+	
+	if (ahead == 0)
+	{
+		return profileDrive(dist);
+	}
+	
+	//Hand over to the next move as the profile passes the end, still moving
+	profileDrive(dist + ahead);
+	
+	DriveHandOver = (dist >= 0) ? DriveProfile.GetPos() >= dist : DriveProfile.GetPos() <= dist;
+	DriveCarry = DriveProfile.GetPos() - dist;
+	
+	return DriveHandOver;
+}
+
+//Stop the wheels, unless the move was handed over at speed
+void exitStraight(void)
+{
+	if (!DriveHandOver) {setWheelSpeeds(0, 0);}
+}
+
+
+//Turn in place by NavArg degrees
+bool stepTurn(U32 tick, bool first)
+{
+	(void) tick;
+	
+	return profileTurn(INT2Q16(NavArg), first, false);
+}
+
+void exitTurn(void)
+{
+	setWheelSpeeds(0, 0);
+}
+
+
+//Stop the wheels where they are and beep
+void exitStop(void)
+{
+	setWheelSpeeds(0, 0);
+	mSpeak.playTone(500,50,20);
+}
+
+
+//Measure the wheel geometry
+bool stepCalibrate(U32 tick, bool first)
+{
+	(void) tick;
+	
+	return calibrate(first);
+}
+
+//Just beep
+void exitBeep(void)
+{
+	mSpeak.playTone(500,50,20);
+}
+
+
+//Turn in place until the line is under MainLight
+bool stepTurnAround(U32 tick, bool first)
+{
+	(void) tick;
+	
+	return profileTurn(INT2Q16(TURN_AROUND_ANGLE), first, true);
+}
+
+//Straight into following it, the line follower takes the wheels from here
+void exitTurnAround(void)
+{
+	startLineFollow();
+	mSpeak.playTone(500,50,20);
+}
+
+
+/**************************************************************************************
+ * Navigation Table
+ **************************************************************************************/
+//Nav states which are only ever run after another one, never put in task_NavState
+#define NAV_CROSS_CENTER  (NUM_NAV_STATES + 0)
+#define NAV_SUPPLY_LINE   (NUM_NAV_STATES + 1)
+#define NUM_NAV_ROWS      (NUM_NAV_STATES + 2)
+
+//Most states run in one cycle, in case a table mistake makes a loop
+#define NAV_MAX_HOPS      4
+
+//One nav state
+struct NavBehavior
+{
+	bool (*p_Enter)(U32 tick);            /**<Set up, false if it can't run. 0 for none.*/
+	bool (*p_Step)(U32 tick, bool first); /**<Run one cycle, true when done*/
+	void (*p_Exit)(void);                 /**<Finish up once done. 0 for none.*/
+	U8 next;                              /**<State to run once done*/
+};
+
+//Every nav state, in order of its number
+const NavBehavior NavTable[NUM_NAV_ROWS] =
+{
+	{0,                 stepIdle,         0,              NAV_IDLE},        //NAV_IDLE
+	{0,                 stepToLine,       exitCenterLine, NAV_CROSS_CENTER},//NAV_TO_SUPPLY
+	{enterApproachWall, stepApproachWall, exitStop,       NAV_IDLE},        //NAV_APPROACH_WALL
+	{enterBackUp,       stepBackUp,       exitStop,       NAV_IDLE},        //NAV_BACK_UP
+	{0,                 stepTurnAround,   exitTurnAround, NAV_IDLE},        //NAV_TURN_AROUND
+	{enterRoute,        stepRoute,        exitRoute,      NAV_IDLE},        //NAV_TO_SCORE
+	{0,                 stepCalibrate,    exitBeep,       NAV_IDLE},        //NAV_CALIBRATE
+	{enterRoute,        stepRoute,        exitRoute,      NAV_IDLE},        //NAV_ROUTE
+	{enterStraight,     stepStraight,     exitStraight,   NAV_IDLE},        //NAV_STRAIGHT
+	{0,                 stepTurn,         exitTurn,       NAV_IDLE},        //NAV_TURN
+	{0,                 stepToLine,       exitCenterLine, NAV_IDLE},        //NAV_FOLLOW_LINE
+	{enterCross,        stepCross,        0,              NAV_SUPPLY_LINE}, //NAV_CROSS_CENTER
+	{0,                 stepToLine,       exitSupplyLine, NAV_IDLE}         //NAV_SUPPLY_LINE
+};
+
+TaskShare<bool> task_NavDone;
+
+
+/**************************************************************************************
+ * Queue Nav Move
+ **************************************************************************************/
+/** @brief   Add a nav state to the end of @c NavQueue
+ *  @details Can be called from any task. The move starts as soon as nav has
+ * 			 finished everything before it, or straight away if nav is idle.
+ *  @param   state The state, one of the public ones other than @c NAV_IDLE
+ *  @param   arg   Its argument, see @c NavMove
+ *  @return  False if the state isn't one that can be queued or the queue is full
+ */
+
+bool queueNavMove(U8 state, S16 arg)
+{
+	NavMove move;
+	
+	if (state == NAV_IDLE || state >= NUM_NAV_STATES) {return false;}
+	
+	move.state = state;
+	move.arg = arg;
+	
+	return NavQueue.put(move);
+}
+
+
+/**************************************************************************************
+ * Enter Nav State
+ **************************************************************************************/
+/** @brief   Start running a row of @c NavTable
+ *  @details Going back to @c NAV_IDLE, or a state that can't start, finishes
+ * 			 the command. @c NavMovesDone counts it, and the next move in
+ * 			 @c NavQueue is started in its place. With nothing queued
+ * 			 @c task_NavState goes back to @c NAV_IDLE and @c task_NavDone is
+ * 			 set.
+ *  @param   row  The state to run
+ *  @param   tick Current time
+ */
+
+void enterNavState(U8 row, U32 tick)
+{
+	NavMove move;
+	
+	while (true)
+	{
+		if (row >= NUM_NAV_ROWS) {row = NAV_IDLE;}
+		
+		NavRow = row;
+		NavFirst = true;
+		
+		if (row != NAV_IDLE)
+		{
+			if (NavTable[row].p_Enter != 0 && !NavTable[row].p_Enter(tick))
+			{
+				NavRow = NAV_IDLE;
+			}
+			
+			//Only the move right after a straight can carry on from it
+			DriveHandOver = false;
+		}
+		
+		if (NavRow != NAV_IDLE || NavCommand == NAV_IDLE) {return;}
+		
+		//The command is finished
+		NavMovesDone.put(++NavCompleted);
+		
+		if (!NavQueue.get(move)) {break;}
+		
+		NavCommand = move.state;
+		NavArg = move.arg;
+		task_NavState.put(NavCommand);
+		row = NavCommand;
+	}
+	
+	//A straight handed over to nothing, so stop it here
+	if (DriveHandOver)
+	{
+		DriveHandOver = false;
+		setWheelSpeeds(0, 0);
+	}
+	
+	NavCommand = NAV_IDLE;
+	task_NavState.put(NAV_IDLE);
+	task_NavDone.put(true);
+}
+
+
+/**************************************************************************************
+ * Cancel Nav State
+ **************************************************************************************/
+/** @brief   Stop the row being run when a new command takes its place
+ *  @details The row's exit isn't run, since that is for finishing it, and
+ * 			 some exits record where the robot got to. Instead the wheels are
+ * 			 stopped and the line follower let go, which are the only things a
+ * 			 row can leave running. Cancelling to @c NAV_IDLE also drops any
+ * 			 queued moves, or the next one would just start.
+ *  @param   command The command taking over
+ */
+
+void cancelNavState(U8 command)
+{
+	NavMove move;
+	
+	if (NavRow != NAV_IDLE || DriveHandOver)
+	{
+		DriveHandOver = false;
+		task_LFStart.put(false);
+		setWheelSpeeds(0, 0);
+	}
+	
+	if (command == NAV_IDLE)
+	{
+		while (NavQueue.get(move)) {}
+	}
+}
+
+
+/**************************************************************************************
+ * Task Nav Constructor
+ **************************************************************************************/
+/** @brief   Constructor for the navigation task
+ *  @details 
+ *  
+ */
+
+
+void NavConstructor(void)
+{
+	
+	task_NavState.put(NAV_IDLE);
+	task_NavDone.put(true);
+	NavMovesDone.put(0);
+	
+	//Start tracking from here
+	myBot.Reset();
+	shareWheelSpeeds();
+	
+	//Let the turn routines and the drive task know the wheel geometry
+	shareGeometry();
+	
+	if (!StatsPageOn.get())
+	{
+		Display.cursor(0,NAV_LINE);
+		Display.putf("s\n", "Nav Ready");
+		Display.disp();
+	}
+	
+}
+
+
+
+/**************************************************************************************
+ * Task Nav Run Method (infinite loop)
+ **************************************************************************************/
+/** @brief   Run method for the navigation task
+ *  @details Each cycle a new command in @c task_NavState, or a move queued while
+ * 			 idle, starts its row of @c NavTable, then the current row is stepped. When a row is done its
+ * 			 exit runs and the next row is entered and stepped straight away, so
+ * 			 a chain of states loses no cycles between them.
+ */
+
+
+void NavRun(void)
+{
+	U32 currentTime;
+	U8 command;
+	U8 hops;
+	const NavBehavior* p_Row;
+	NavMove move;
+	
+	//Go forever!
+	while(true)
+	{		
+		currentTime = NNxt::getTick();		
+		
+		//Integrate the encoder samples taken since last time
+		myBot.Update();
+		shareWheelSpeeds();
+		
+		command = task_NavState.get();
+		
+		//Snap to any line just crossed, unless the geometry is being measured
+		if (command != NAV_CALIBRATE)
+		{
+			checkLandmarks(currentTime);
+		}
+		
+		//A new command from the master mind
+		if (command != NavCommand)
+		{
+			NavCommand = (command < NUM_NAV_STATES) ? command : (U8) NAV_IDLE;
+			cancelNavState(NavCommand);
+			NavArg = task_NavGoal.get();
+			task_NavDone.put(NavCommand == NAV_IDLE);
+			enterNavState(NavCommand, currentTime);
+		}
+		
+		//Or the first move put in the queue while idle
+		else if (NavCommand == NAV_IDLE && NavQueue.get(move))
+		{
+			NavCommand = move.state;
+			NavArg = move.arg;
+			task_NavState.put(NavCommand);
+			task_NavDone.put(false);
+			enterNavState(NavCommand, currentTime);
+		}
+		
+		for (hops = 0; hops < NAV_MAX_HOPS; hops++)
+		{
+			p_Row = &NavTable[NavRow];
+			
+			if (!p_Row -> p_Step(currentTime, NavFirst))
+			{
+				NavFirst = false;
+				break;
+			}
+			
+			if (p_Row -> p_Exit != 0) {p_Row -> p_Exit();}
+			
+			enterNavState(p_Row -> next, currentTime);
+		}
 		
 		
 		//Let other tasks run
-		sleep_from_for(currentTime, 20);
+		sleep_from_for(currentTime, NAV_PERIOD);
 		
 	}//End while
 }
@@ -0,0 +1,179 @@
+//*************************************************************************************
+/** @file    task_Sonar.cpp
+ *  @brief   A task which reads the sonar in the background
+ *  @details The sonar is an I2C sensor which only comes up with a new distance
+ * 			 every few tens of ms. This task is the only one that talks to it. It
+ * 			 reads it once a sonar period and puts the distance in @c SonarData
+ * 			 with the time it was measured, so the nav task never waits on the
+ * 			 bus and can tell how old its wall distance is.
+ *
+ *  Revised:
+ *     \li 10-18-2026 ARB Original file, moved out of task_Navigation.cpp
+ *     \li 10-18-2026 ARB Readings go through a median filter and rate gate
+ *
+ *  License:
+ *		
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+/**************************************************************************************
+ * Include Kernel Files
+ **************************************************************************************/
+
+extern "C" {
+#include "ecrobot_interface.h"
+}
+
+/**************************************************************************************
+ * Include ECROBOT Files
+ **************************************************************************************/
+#include <SonarSensor.h>
+
+/**************************************************************************************
+ * Include Personally Written Files
+ **************************************************************************************/
+#include "../lib/taskshare.hpp"
+#include "shares.hpp"
+#include "../lib/ExtraFunctions.hpp"
+#include "SonarFilterClass.hpp"
+
+/**************************************************************************************
+ * Include NXTexpanded Lib Files
+ **************************************************************************************/
+#include "../../nxtOSEK/NXtpandedLib/src/NNxt.hpp"
+
+
+/**************************************************************************************
+ * Constants
+ **************************************************************************************/
+
+#define SONAR_PERIOD       50  //ms between sonar readings
+#define SONAR_LATENCY      25  //ms from a sonar ping to when it is read, on average
+
+
+/**************************************************************************************
+ * Global Variables
+ **************************************************************************************/
+
+//Create as sonar sensor object to see distance
+ecrobot::SonarSensor Sonar(SonarPort);
+
+//Throws out stray echoes before they are shared
+SonarFilterClass SonarFilter;
+
+TaskShare<SonarReading> SonarData;
+
+
+
+/**************************************************************************************
+ * Task Sonar Constructor
+ **************************************************************************************/
+/** @brief   Constructor for the sonar task
+ *  @details Clears the share so nobody uses a reading before the first one.
+ */
+
+
+void SonarConstructor(void)
+{
+	SonarReading reading;
+	
+	reading.cm = 0;
+	reading.tick = 0;
+	reading.count = 0;
+	
+	SonarData.put(reading);
+}
+
+
+
+/**************************************************************************************
+ * Task Sonar Run Method (infinite loop)
+ **************************************************************************************/
+/** @brief   Run method for the sonar task
+ *  @details Reads the sonar every @c SONAR_PERIOD ms. Any wait on the I2C bus
+ * 			 (@c EventSleepI2C) happens here, in a task below nav, instead of
+ * 			 in the nav loop. Only readings which get through @c SonarFilter are
+ * 			 shared, stamped with when the ping was measured rather than when it
+ * 			 was read.
+ */
+
+
+void SonarRun(void)
+{
+	U32 currentTime;
+	SonarReading reading;
+	
+	reading.count = 0;
+	
+	//Go forever!
+	while(true)
+	{		
+		currentTime = NNxt::getTick();		
+		
+		if (SonarFilter.Add((S16) Sonar.getDistance(), currentTime - SONAR_LATENCY))
+		{
+			reading.cm = SonarFilter.GetCm();
+			reading.tick = SonarFilter.GetTick();
+			reading.count++;
+			
+			SonarData.put(reading);
+		}
+		
+		//Let other tasks run
+		sleep_from_for(currentTime, SONAR_PERIOD);
+		
+	}//End while
+}
+	
+
+
+
+/**************************************************************************************
+ * Task Sonar
+ **************************************************************************************/
+/** @brief   Sonar task
+ *  @details Waits until the nav task is allowed to start, since nav is the only
+ * 			 user of the readings. Then runs the constructor and the run method.
+ * 			 The run method will *never* exit. And if it somehow does the task
+ * 			 will just exit.  
+ */
+
+
+extern "C"
+{
+
+
+TASK(SonarTask)
+{
+	//Wait until permission to start is given
+
+	while(task_NavStart.get() != true) 
+	{	
+		//Let other tasks run
+		NNxt::sleep(500);
+	}
+	
+	//Runs once
+	SonarConstructor();
+
+	//This loops forever
+	SonarRun();
+	
+	//shouldn't ever get here
+	TerminateTask();
+}
+
+}
@@ -7,6 +7,7 @@
  *
  *  Revised:
  *     \li 02-16-2015 ARB Original file
+ *     \li 10-18-2026 ARB Added StatsPageOn
  *
  *  License:
  *		
@@ -35,6 +36,7 @@
 
 
 #include "../lib/taskshare.hpp"
+#include "../lib/taskqueue.hpp"
 
 
 /**************************************************************************************
@@ -78,6 +80,11 @@ extern const ePortM TowerPort;
 //Shared vaiable to tell SlaveMind task when to start
 extern TaskShare<bool> task_SlaveMindStart;
 
+//Tuning parameters, from lib/ParamTable.hpp. The master fills these in during
+//the comm handshake, so only read them after CommReady is set.
+class ParamTable;
+extern ParamTable SlaveParams;
+
 
 //---------Lifter----------------------
 
@@ -121,6 +128,10 @@ extern TaskShare<bool> task_CommStart;
 //Shared vaiable to tell others when the comm task is ready
 extern TaskShare<bool> CommReady;
 
+//True while the comm task shows the link statistics page, which takes the whole
+//screen. Don't write to the screen while it is set.
+extern TaskShare<bool> StatsPageOn;
+
 //Shared variable containing the dataID information so the reciever knows what to do
 //This is sent as a union and decoded by the task getting the info
 extern TaskShare<U8> ShareMsgID;
@@ -128,8 +139,14 @@ extern TaskShare<U8> ShareMsgID;
 //Shared vaiable to tell others when a message is ready to be recieved (Comm->SMind)
 extern TaskShare<bool> MsgReady2Get;
 
-//Shared vaiable to tell others when a message is ready to be sent (SMind->Comm)
-extern TaskShare<bool> MsgReady2Send;
+//Queue of message IDs waiting to be sent to the other brick (Mind->Comm).
+//Use Comm.Post() to add to it.
+struct CommTxMsg;
+extern TaskQueue<CommTxMsg> CommTxQueue;
+
+//The link itself, from lib/CommEngine.hpp
+class CommEngine;
+extern CommEngine Comm;
 
 
 
@@ -7,6 +7,7 @@
  *
  *  Revised:
  *     \li 02-26-2015 ARB Original file
+ *     \li 10-18-2026 ARB Leaves the screen alone while the link statistics page is shown
  *
  *  License:
  *		
@@ -118,9 +119,12 @@ void ClawConstructor(void)
 	
 	//claw is now ready for operation.	
 	//Notify user
-	Display.cursor(0,CLAW_LINE);
-	Display.putf("s\n", "Claw Ready");
-	Display.disp();
+	if (!StatsPageOn.get())
+	{
+		Display.cursor(0,CLAW_LINE);
+		Display.putf("s\n", "Claw Ready");
+		Display.disp();
+	}
 }
 
 
@@ -7,6 +7,8 @@
  *
  *  Revised:
  *     \li 02-24-2015 ARB Original file
+ *     \li 10-18-2026 ARB Gains read from the SlaveParams table
+ *     \li 10-18-2026 ARB Leaves the screen alone while the link statistics page is shown
  *
  *  License:
  *		
@@ -45,6 +47,7 @@
 #include "../lib/taskshare.hpp"
 #include "shares.hpp"
 #include "../lib/ExtraFunctions.hpp"
+#include "../lib/ParamTable.hpp"
 
 /**************************************************************************************
  * Include NXTexpanded Lib Files
@@ -56,8 +59,6 @@
  * Constants
  **************************************************************************************/
 #define CLOSE_ENOUGH 10  //Number of encoder ticks deemed close enough to desired position
-#define Kp 1
-#define Ki 0.001
 #define LONG_ENOUGH 5  //Number of times the touch sensor needs to read pressed to turn off motor
 #define DOWN_MAX  -70
 #define UP_MAX  70
@@ -130,9 +131,12 @@ void LifterConstructor(void)
 	
 	//Lifter is now ready for operation.	
 	//Notify user
-	Display.cursor(0,LIFTER_LINE);
-	Display.putf("s\n", "Lifter Ready");
-	Display.disp();
+	if (!StatsPageOn.get())
+	{
+		Display.cursor(0,LIFTER_LINE);
+		Display.putf("s\n", "Lifter Ready");
+		Display.disp();
+	}
 }
 
 
@@ -217,7 +221,9 @@ void LifterRun(void)
 				//Otherwise, continue running the control loop
 				else
 				{
-					power = Kp * error + Ki * error_sum / 1024;
+					//Gains come from the tuning table (parLiftKp, parLiftKi)
+					power = SlaveParams.get(ParamTable::parLiftKp) * error
+						  + SlaveParams.get(ParamTable::parLiftKi) * error_sum / 1024;
 					
 					//Cap max power
 					if (power > UP_MAX) {power = UP_MAX;}
@@ -6,6 +6,9 @@
  *
  *  Revised:
  *     \li 03-03-2015 ARB Original file
+ *     \li 10-18-2026 ARB Link handling moved to the shared CommEngine in lib/
+ *     \li 10-18-2026 ARB Tuning parameters are downloaded from the master
+ *     \li 10-18-2026 ARB Added StatsPageOn for the link statistics page
  *
  *  License:
  *		
@@ -25,16 +28,10 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 //*************************************************************************************
 
-/**************************************************************************************
- * Include C/C++ Files
- **************************************************************************************/
-#include "../../yagarto-old/arm-none-eabi/include/c++/4.6.2/cstring"
-
 /**************************************************************************************
  * Include ECROBOT Files
  **************************************************************************************/
-#include <Rs485.h>
-#include <Speaker.h>
+#include <Lcd.h>
 
 /**************************************************************************************
  * Include Personally Written Files
@@ -42,8 +39,8 @@
 #include "../lib/taskshare.hpp"
 #include "shares.hpp"
 #include "../lib/ExtraFunctions.hpp"
-//#include "../lib/RS485Header.hpp"
-#include "../lib/MessageClass.hpp"
+#include "../lib/CommEngine.hpp"
+#include "../lib/ParamTable.hpp"
 
 /**************************************************************************************
  * Include NXTexpanded Lib Files
@@ -54,99 +51,55 @@
 /**************************************************************************************
  * Constants
  **************************************************************************************/
-#define TIMEOUT 50
+#define PARAM_WAIT 1500 //ms to wait for the master's tuning table before using defaults
+#define PARAM_POLL 10   //ms between polls of the link while waiting
+
 
 /**************************************************************************************
  * Global Variables
  **************************************************************************************/
-
-
 TaskShare<bool> CommReady;
+TaskShare<bool> StatsPageOn;
 TaskShare<U8> ShareMsgID;
 TaskShare<bool> MsgReady2Get;
-TaskShare<bool> MsgReady2Send;
+TaskQueue<CommTxMsg> CommTxQueue;
 
-ecrobot::Speaker mSpeak;
+//The link to the master, received messages go to the ShareMsgID mailbox
+CommEngine Comm(CommEngine::roleSlave, &CommTxQueue, &ShareMsgID, &MsgReady2Get);
+
+//Set once a tuning table from the master has been loaded
+bool ParamsLoaded = false;
 
 
 /**************************************************************************************
- * Send Ack
+ * Frame Handler
  **************************************************************************************/
-/** @brief   Send acknowledgement of message
- *  @details 
- *  
+/** @brief   Handle frames from the master
+ *  @details A tuning table replaces the values in @c SlaveParams. It is always
+ * 			 answered with the checksum of the table as it is now, so the master
+ * 			 can tell whether to send it again.
+ *  @param   dType The type of data in the frame
+ *  @param   dID   What the frame holds
+ *  @param   data  The data in the frame
+ *  @param   len   Number of data bytes
  */
 
-void SendAck(void)
+void CommFrame(MessageClass::comDatatype dType, MessageClass::comDataID dID, U8* data, U8 len)
 {
-	MessageClass AckMsg;
+	U8 sum;
 
-	MessageClass::comDataID   msgID = MessageClass::idAckMsg;
- 
-	AckMsg.SendMsgSimple(msgID);
-}
-
-
-
-/**************************************************************************************
- * Wait for Ack
- **************************************************************************************/
-/** @brief    Was there acknowledgement of message?
- *  @details 
- *  
- */
+	(void) dType;
 
-bool isAck(void)
-{
-	bool ack = false;	
-	MessageClass AckMsg;	
-	MessageClass::comDataID   msgID = MessageClass::idNoMsg;
-	
-	msgID = AckMsg.GetMsgSimple();
-		
-		if(msgID == MessageClass::idAckMsg)
+	if (dID == MessageClass::idParamTable)
+	{
+		if (SlaveParams.Load(data, len))
 		{
-			ack = true;			
+			ParamsLoaded = true;
 		}
-	
-	return ack;	
-}
 
-
-/**************************************************************************************
- * Easy function to write debug msgs
- **************************************************************************************/
-/** @brief   Write sequential debug msgs
- *  @details This function writes messages on the screen one line
- * 			 at a time and then loops back and erases old stuff after a while.
- * @param    msg The message to write
- * 		
- */
-
-U8 curLine = 1;
-
-void debug (const char* msg)
-{
-
-	Display.clearRow(curLine);
-	Display.cursor(0,curLine);
-	Display.putf("s\n", msg);
-	Display.disp();
-	
-	curLine++;
-	if(curLine > 7) curLine = 1;
-}
-
-void debugnum (U8 msg, U8 dir)
-{
-
-	Display.clearRow(curLine);
-	Display.cursor(0,curLine);
-	Display.putf("dsd\n", msg,0, ",", dir,0);
-	Display.disp();
-	
-	curLine++;
-	if(curLine > 7) curLine = 1;
+		sum = CommEngine::CRC8(0, SlaveParams.data(), ParamTable::TABLE_BYTES);
+		Comm.SendFrame(&sum, MessageClass::typeU8, MessageClass::idParamAck, 1);
+	}
 }
 
 
@@ -154,137 +107,52 @@ void debugnum (U8 msg, U8 dir)
  * Task Comm Constructor
  **************************************************************************************/
 /** @brief   Constructor for the comm task
- *  @details Sets up RS485 port and sends ready message to master
+ *  @details Clears the mailbox, wakes up the link to the master and waits
+ * 			 for the master to send the tuning table. If it doesn't come the
+ * 			 defaults in @c SlaveParams are used.
  *  
  */
 
-
 void CommConstructor(void)
 {
+	U32 start;
 	
 	//Initialze Shared Variables
 	ShareMsgID.put(0);
 	MsgReady2Get.put(false);
-	MsgReady2Send.put(false);	
 	
-	//Send awake message	
-	MessageClass WakeMsg;
-	MessageClass::comDataID wakeID = MessageClass::idWakeMsg;
+	Comm.setFrameHandler(CommFrame);
+	Comm.setStatsPageFlag(&StatsPageOn);
+	
+	//Returns once the master has answered
+	Comm.Handshake();
 	
-	WakeMsg.SendMsgSimple(wakeID);
+	//The master sends the table right after the handshake
+	start = NNxt::getTick();
 	
-	while  (isAck() == false)
+	while (ParamsLoaded == false && NNxt::getTick() - start < PARAM_WAIT)
 	{
-		NNxt::sleep(50);
-	}	
+		Comm.Poll();
+		NNxt::sleep(PARAM_POLL);
+	}
 	
 	CommReady.put(true);
 	
 	//Comm is now ready for operation.	
 	//Notify user
-	//mSpeak.playTone(400,50,20);
 	Display.cursor(0,COMM_LINE);
-	Display.putf("s\n", "Comm Ready");
+	Display.putf("s\n", (ParamsLoaded) ? "Comm Ready" : "Comm Ready, Dflt");
 	Display.disp();
 }
 
 
 
-/**************************************************************************************
- * Task Comm Run Method (infinte loop)
- **************************************************************************************/
-/** @brief   Run method for the comm task
- *  @details Runs a loop which waits for messages from the master.
- *	     It then acknowledges the message and passes the needed information
- * 	     to the SlaveMind task. It can also send messages to the master to
- * 	     notify it of useful events.
- */
-
-
-void CommRun(void)
-{
-	//Task Vars
-	enum state_t {IDLE, SEND, GET} state = IDLE;
-	U32 currentTime;
-	
-	//Message Vars
-	MessageClass* p_curMsg = new MessageClass;
-	MessageClass::comDataID   msgID;
-
-	
-	//Go forever!
-	while(true)
-	{
-		
-		currentTime = NNxt::getTick();
-		
-		switch (state)
-		{
-			
-			case IDLE:
-				
-				//Check if a there is an incomming message
-				p_curMsg -> GetMsgSimple();
-				if (p_curMsg -> isEmptySimple() == false)
-				{
-					state = GET;
-					break;
-				}
-				
-				//Check if there is a message to send
-				if (MsgReady2Send.get() == true)
-				{
-					state = SEND;
-				}
-				
-				break;
-			
-			
-			case SEND:
-				
-				//Send the message
-				msgID = static_cast<MessageClass::comDataID> (ShareMsgID.get());
-				p_curMsg -> SendMsgSimple(msgID);
-			
-// 				debugnum(ShareMsgID.get(),1);
-				
-				MsgReady2Send.put(false);
-				state = IDLE;
-				break;
-				
-			
-			case GET:
-				
-				//Get the message info
-				msgID = p_curMsg -> GetMsgDataSimple();
-				
-				//Get message info
-				ShareMsgID.put(msgID);
-				MsgReady2Get.put(true);
-				
-// 				debugnum(ShareMsgID.get(),0);
-
-				state = IDLE;	
-			
-				break;
-					
-		}//End switch
-		
-		//Let other tasks run
-		sleep_from_for(currentTime, 10);
-		
-	}//End while
-}
-	
-
-
-
 /**************************************************************************************
  * Task Comm
  **************************************************************************************/
 /** @brief   Comm task
  *  @details Waits until the start variable is set. Then runs the 
-*	     constructor and the run method. The run method will 
+*	     constructor and the engine's run method. The run method will 
 *	     *never* exit. And if it somehow does the task will just
 *	      exit.  
  */
@@ -308,7 +176,7 @@ TASK(CommTask)
 	CommConstructor();
 
 	//This loops forever
-	CommRun();
+	Comm.Run();
 	
 	//shouldn't ever get here
 	TerminateTask();
@@ -10,6 +10,8 @@
  *
  *  Revised:
  *     \li 02-16-2015 ARB Original file
+ *     \li 10-18-2026 ARB Tuning constants moved to the SlaveParams table
+ *     \li 10-18-2026 ARB Leaves the screen alone while the link statistics page is shown
  *
  *  License:
  *		
@@ -46,7 +48,8 @@
 #include "../lib/taskshare.hpp"
 #include "shares.hpp"
 #include "../lib/ExtraFunctions.hpp"
-#include "../lib/MessageClass.hpp"
+#include "../lib/CommEngine.hpp"
+#include "../lib/ParamTable.hpp"
 
 /**************************************************************************************
  * Include NXTexpanded Lib Files
@@ -71,17 +74,13 @@
 // #define HIGH_SCORE_LOWER  11.5
 // #define HIGH_SCORE_HIGHER 12.1
 
-#define PRE_GRAB_HEIGHT   2.5
-#define GRAB_HEIGHT       3.25
-#define POST_GRAB_HEIGHT  3.75
 
-#define PRE_RELEASE_HEIGHT  11.5
-#define RELEASE_HEIGHT   	11.0
-#define POST_RELEASE_HEIGHT 10.25
-
-//For unit converstion
-#define SCALE 571.51
-#define ZERO  -1516
+/**************************************************************************************
+ * Tuning parameters
+ **************************************************************************************/
+//Start out with the values from ParamTable.hpp. The master sends the ones it was
+//built with during the comm handshake, and those replace them.
+ParamTable SlaveParams(SlaveTuningValues);
 
 /**************************************************************************************
  * Converstion from height to degrees for lifter
@@ -97,7 +96,7 @@
 
 S32 InchestoDegrees(float height)
 {
-	return (height * SCALE) + ZERO;
+	return (height * SlaveParams.get(ParamTable::parLiftScale)) + SlaveParams.get(ParamTable::parLiftZero);
 	
 }
 
@@ -172,10 +171,13 @@ void debug (const char* msg)
 {
 	static U8 curLine = 1;
 
-	Display.clearRow(curLine);
-	Display.cursor(0,curLine);
-	Display.putf("s\n", msg);
-	Display.disp();
+	if (!StatsPageOn.get())
+	{
+		Display.clearRow(curLine);
+		Display.cursor(0,curLine);
+		Display.putf("s\n", msg);
+		Display.disp();
+	}
 	
 	curLine++;
 	if(curLine > 7) curLine = 1;
@@ -222,12 +224,14 @@ void SlaveMindConstructor(void)
 	//Wait till claw task is done initializing
 	while(ClawArrived.get() == false) {NNxt::sleep(50);}
 	
-	ShareMsgID.put((U8) MessageClass::idInitDone);
-	MsgReady2Send.put(true);
+	Comm.Post(MessageClass::idInitDone);
 	
-	Display.cursor(0,MIND_LINE);
-	Display.putf("s\n", "SlaveMind Ready");
-	Display.disp();
+	if (!StatsPageOn.get())
+	{
+		Display.cursor(0,MIND_LINE);
+		Display.putf("s\n", "SlaveMind Ready");
+		Display.disp();
+	}
 	
 }
 
@@ -254,9 +258,12 @@ void SlaveMindRun(void)
 	U8 grabStage = 0;
 	U8 placeStage = 0;
 	
-	Display.clear(true);
-	Display.putf("s\n", "Slave Running");
-	Display.disp();
+	if (!StatsPageOn.get())
+	{
+		Display.clear(true);
+		Display.putf("s\n", "Slave Running");
+		Display.disp();
+	}
 	
 	while(true)
 	{		
@@ -293,7 +300,7 @@ void SlaveMindRun(void)
 				
 				//Move Lifter to bottom, open claw
 				moveClaw.put(OPENCLAW);
-				MoveLift(PRE_GRAB_HEIGHT);
+				MoveLift(SlaveParams.get(ParamTable::parPreGrabHeight));
 				
 				//Wait till action is completed
 				if(ReadyToCheck() && ClawArrived.get() && LifterArrived.get())
@@ -305,8 +312,7 @@ void SlaveMindRun(void)
 					ReadyToCheck(true);
 					
 					//Send message to Master to let it know we are done.
-					ShareMsgID.put((U8) MessageClass::idReadytoGrab);
-					MsgReady2Send.put(true);
+					Comm.Post(MessageClass::idReadytoGrab);
 				}				
 		
 				break;
@@ -318,7 +324,7 @@ void SlaveMindRun(void)
 				//Raise lifter to grab height
 				if(grabStage == 0)
 				{
-					if(MoveLift(GRAB_HEIGHT)) 
+					if(MoveLift(SlaveParams.get(ParamTable::parGrabHeight))) 
 					{
 						grabStage = 1;
 						
@@ -345,7 +351,7 @@ void SlaveMindRun(void)
 				//Lift off of peg
 				if(grabStage == 2)
 				{
-					if(MoveLift(POST_GRAB_HEIGHT)) 
+					if(MoveLift(SlaveParams.get(ParamTable::parPostGrabHeight))) 
 					{
 						grabStage = 0;
 						
@@ -356,8 +362,7 @@ void SlaveMindRun(void)
 						ReadyToCheck(true);
 						
 						//Send message to Master to let it know we are done.
-						ShareMsgID.put((U8) MessageClass::idGrabbedRings);
-						MsgReady2Send.put(true);
+						Comm.Post(MessageClass::idGrabbedRings);
 					}
 					
 				}				
@@ -369,7 +374,7 @@ void SlaveMindRun(void)
 				//debug("PREP2PLACE");				
 				
 				///Move Lifter to top
-				MoveLift(PRE_RELEASE_HEIGHT);
+				MoveLift(SlaveParams.get(ParamTable::parPreReleaseHeight));
 				
 				//Wait till action is completed
 				if(ReadyToCheck() && LifterArrived.get())
@@ -381,8 +386,7 @@ void SlaveMindRun(void)
 					ReadyToCheck(true);
 					
 					//Send message to Master to let it know we are done.
-					ShareMsgID.put((U8) MessageClass::idReadytoPlace);
-					MsgReady2Send.put(true);
+					Comm.Post(MessageClass::idReadytoPlace);
 				}
 				
 				break;
@@ -394,7 +398,7 @@ void SlaveMindRun(void)
 				//Raise lifter to grab height
 				if(placeStage == 0)
 				{
-					if(MoveLift(RELEASE_HEIGHT)) 
+					if(MoveLift(SlaveParams.get(ParamTable::parReleaseHeight))) 
 					{
 						placeStage = 1;
 						
@@ -421,7 +425,7 @@ void SlaveMindRun(void)
 				//Lift off of peg
 				if(placeStage == 2)
 				{
-					if(MoveLift(POST_RELEASE_HEIGHT)) 
+					if(MoveLift(SlaveParams.get(ParamTable::parPostReleaseHeight))) 
 					{
 						placeStage = 0;
 						
@@ -432,8 +436,7 @@ void SlaveMindRun(void)
 						ReadyToCheck(true);
 						
 						//Send message to Master to let it know we are done.
-						ShareMsgID.put((U8) MessageClass::idPlacedRings);
-						MsgReady2Send.put(true);
+						Comm.Post(MessageClass::idPlacedRings);
 					}
 					
 				}	
@@ -8,6 +8,7 @@
  *
  *  Revised:
  *     \li 02-26-2015 ARB Original file
+ *     \li 10-18-2026 ARB Leaves the screen alone while the link statistics page is shown
  *
  *  License:
  *		
@@ -117,9 +118,12 @@ void TowerConstructor(void)
 	
 	//Tower is now ready for operation.	
 	//Notify user
-	Display.cursor(0,TOWER_LINE);
-	Display.putf("s\n", "Tower Ready");
-	Display.disp();
+	if (!StatsPageOn.get())
+	{
+		Display.cursor(0,TOWER_LINE);
+		Display.putf("s\n", "Tower Ready");
+		Display.disp();
+	}
 }
 
 
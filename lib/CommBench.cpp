@@ -0,0 +1,488 @@
+//*************************************************************************************
+/** @file    CommBench.cpp
+ *  @brief   Runs both ends of the comm link on a PC to measure how it copes
+ *  @details This is not part of either brick's build. It runs the real
+ * 			 @c CommEngine twice, as the Master and as the Slave, in two threads
+ * 			 joined by the simulated cable in Rs485Sim.hpp. Each thread polls
+ * 			 its engine every @c COMM_PERIOD ms, like the comm tasks do.
+ *
+ * 			 After the handshake the Master sends numbered frames as fast as
+ * 			 the load setting asks, and both ends post a simple message every
+ * 			 poll. The Slave notes when each frame arrives. At the end it prints
+ * 			 \li Handshake time, and the wake messages sent again
+ * 			 \li Throughput: frames and payload bytes delivered per second, and
+ * 				 how much of the line was asked for
+ * 			 \li Latency: send to arrival of each frame, and the ping round trip
+ * 				 the engines measure themselves
+ * 			 \li Recovery: for each run of lost frames, the time from sending
+ * 				 the first of them to the arrival of the next good one
+ * 			 \li What the cable did: bytes lost and corrupted, frames dropped on
+ * 				 the CRC or part way through, and any corrupt frame that got past
+ * 				 the CRC
+ *
+ * 			 With no arguments it runs a set of cables from clean to bad. Given
+ * 			 arguments it runs just the one described by them.
+ *
+ * 			 Build and run with:
+ * 			 @code
+ * 			 g++ -O2 -DHOST_BUILD CommBench.cpp -o CommBench -lpthread
+ * 			 ./CommBench [baud latency_ms loss_ppt corrupt_ppt [seconds [frames_per_poll]]]
+ * 			 @endcode
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+#ifndef HOST_BUILD
+#error CommBench.cpp only builds on a PC, with -DHOST_BUILD
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+
+#include "CommEngine.hpp"
+
+
+/**************************************************************************************
+ * Constants
+ **************************************************************************************/
+
+//Number of made up cables
+#define NUM_CABLES 6
+
+//Seconds each made up cable is run for
+#define DEFAULT_SECONDS 5
+
+//Frames the Master sends each poll
+#define DEFAULT_LOAD 1
+
+//ms the Slave keeps polling after the Master stops sending, on top of the latency
+#define DRAIN_TIME 300
+
+//Data ID of the numbered frames. 15 - 49 are free in MessageClass::comDataID.
+#define BENCH_ID ((MessageClass::comDataID) 15)
+
+//Simple messages each end posts every poll
+#define MASTER_MSG MessageClass::idPrepForGrabRings
+#define SLAVE_MSG  MessageClass::idReadytoGrab
+
+//Every brick has a screen, the engine draws its statistics page on it
+ecrobot::Lcd Display;
+
+
+/**************************************************************************************
+ * Types
+ **************************************************************************************/
+
+//A made up cable
+struct Cable
+{
+	const char* name;
+	ecrobot::Rs485::LinkConfig config;
+};
+
+//Data of a numbered frame. The sequence is sent twice, once inverted, to catch
+//corruption the CRC missed.
+struct BenchFrame
+{
+	U32 seq;
+	U32 notSeq;
+	uint64_t sentUs;
+};
+
+//What one run saw
+struct BenchRun
+{
+	ecrobot::Rs485::LinkConfig config;
+	U32 seconds;
+	U32 load;
+
+	volatile bool stopSending;       /**<Set by main when the Master should stop sending*/
+	volatile bool stop;              /**<Set by main when both threads should finish*/
+
+	U32 masterLinkMs;                /**<Time the Master took to finish the handshake*/
+	U32 slaveLinkMs;                 /**<Time the Slave took to finish the handshake*/
+	CommEngine::LinkStats masterStats;
+	CommEngine::LinkStats slaveStats;
+	U32 masterBytesLost;
+	U32 masterBytesCorrupt;
+	U32 slaveBytesLost;
+	U32 slaveBytesCorrupt;
+
+	U32 framesSent;                  /**<Numbered frames the Master sent*/
+	std::vector<uint64_t> sentUs;    /**<When each numbered frame was sent*/
+	std::vector<uint64_t> recvUs;    /**<When each numbered frame arrived, 0 if it didn't*/
+	U32 duplicates;                  /**<Numbered frames which arrived twice*/
+	U32 badFrames;                   /**<Frames which passed the CRC but weren't right*/
+	U32 masterPosts;                 /**<Simple messages the Master posted*/
+	U32 slavePosts;                  /**<Simple messages the Slave posted*/
+	U32 masterMsgs;                  /**<Simple messages from the Master that arrived*/
+	U32 slaveMsgs;                   /**<Simple messages from the Slave that arrived*/
+};
+
+//The run in progress. The handlers have no context pointer, so they use this.
+BenchRun* p_Run = NULL;
+
+
+/**************************************************************************************
+ * Made up cables
+ **************************************************************************************/
+
+const Cable Cables[NUM_CABLES] =
+{
+	{"Clean 115200",        {115200, 0,  0,  0}},
+	{"Clean 57600",         {57600,  0,  0,  0}},
+	{"Latency 20 ms",       {115200, 20, 0,  0}},
+	{"Loss 1%",             {115200, 0,  10, 0}},
+	{"Corrupt 1%",          {115200, 0,  0,  10}},
+	{"Bad 57600, 5 ms, 2%", {57600,  5,  20, 20}}
+};
+
+
+/**************************************************************************************
+ * Helpers
+ **************************************************************************************/
+/** @brief   Time in us, on the same clock as the simulated cable
+ */
+
+uint64_t nowUs(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000ULL + now.tv_nsec / 1000;
+}
+
+/** @brief   A share of a sorted list, for percentiles
+ */
+
+double percentile(const std::vector<double>& sorted, U8 percent)
+{
+	if (sorted.empty()) {return 0;}
+
+	return sorted[(sorted.size() - 1) * percent / 100];
+}
+
+
+/**************************************************************************************
+ * Handlers
+ **************************************************************************************/
+/** @brief   Slave side: note the arrival of a numbered frame
+ */
+
+void slaveFrame(MessageClass::comDatatype dType, MessageClass::comDataID dID, U8* data, U8 len)
+{
+	BenchFrame frame;
+
+	if (dType != MessageClass::typeRaw || dID != BENCH_ID || len != sizeof(frame))
+	{
+		p_Run -> badFrames++;
+		return;
+	}
+
+	memcpy(&frame, data, sizeof(frame));
+
+	if (frame.seq != ~frame.notSeq || frame.seq >= p_Run -> recvUs.size())
+	{
+		p_Run -> badFrames++;
+		return;
+	}
+
+	if (p_Run -> recvUs[frame.seq] != 0)
+	{
+		p_Run -> duplicates++;
+		return;
+	}
+
+	p_Run -> recvUs[frame.seq] = nowUs();
+}
+
+/** @brief   Slave side: count the Master's simple messages
+ */
+
+void slaveMsg(MessageClass::comDataID dID)
+{
+	if (dID == MASTER_MSG) {p_Run -> masterMsgs++;}
+}
+
+/** @brief   Master side: count the Slave's simple messages
+ */
+
+void masterMsg(MessageClass::comDataID dID)
+{
+	if (dID == SLAVE_MSG) {p_Run -> slaveMsgs++;}
+}
+
+
+/**************************************************************************************
+ * Threads
+ **************************************************************************************/
+/** @brief   Plays the Master brick
+ */
+
+void* masterThread(void* p_Arg)
+{
+	BenchRun& run = *(BenchRun*) p_Arg;
+	TaskQueue<CommTxMsg> txQueue;
+	TaskShare<U8> rxID;
+	TaskShare<bool> rxReady;
+	CommEngine engine(CommEngine::roleMaster, &txQueue, &rxID, &rxReady);
+	BenchFrame frame;
+	U32 start = NNxt::getTick();
+
+	ecrobot::Rs485::Attach(ecrobot::Rs485::END_MASTER);
+	engine.setMsgHandler(masterMsg);
+
+	engine.Handshake();
+	run.masterLinkMs = NNxt::getTick() - start;
+
+	while (!run.stop)
+	{
+		U32 currentTime = NNxt::getTick();
+
+		for (U32 n = 0; n < run.load && !run.stopSending && run.framesSent < run.sentUs.size(); n++)
+		{
+			frame.seq = run.framesSent;
+			frame.notSeq = ~frame.seq;
+			frame.sentUs = nowUs();
+
+			run.sentUs[frame.seq] = frame.sentUs;
+			engine.SendFrame((U8*) &frame, MessageClass::typeRaw, BENCH_ID, sizeof(frame));
+			run.framesSent++;
+		}
+
+		if (!run.stopSending && engine.Post(MASTER_MSG)) {run.masterPosts++;}
+
+		engine.Poll();
+
+		sleep_from_for(currentTime, COMM_PERIOD);
+	}
+
+	run.masterStats = engine.GetStats();
+	run.masterBytesLost = ecrobot::Rs485::getBytesLost();
+	run.masterBytesCorrupt = ecrobot::Rs485::getBytesCorrupted();
+
+	return NULL;
+}
+
+/** @brief   Plays the Slave brick
+ */
+
+void* slaveThread(void* p_Arg)
+{
+	BenchRun& run = *(BenchRun*) p_Arg;
+	TaskQueue<CommTxMsg> txQueue;
+	TaskShare<U8> rxID;
+	TaskShare<bool> rxReady;
+	CommEngine engine(CommEngine::roleSlave, &txQueue, &rxID, &rxReady);
+	U32 start = NNxt::getTick();
+
+	ecrobot::Rs485::Attach(ecrobot::Rs485::END_SLAVE);
+	engine.setMsgHandler(slaveMsg);
+	engine.setFrameHandler(slaveFrame);
+
+	engine.Handshake();
+	run.slaveLinkMs = NNxt::getTick() - start;
+
+	while (!run.stop)
+	{
+		U32 currentTime = NNxt::getTick();
+
+		if (!run.stopSending && engine.Post(SLAVE_MSG)) {run.slavePosts++;}
+
+		engine.Poll();
+
+		sleep_from_for(currentTime, COMM_PERIOD);
+	}
+
+	run.slaveStats = engine.GetStats();
+	run.slaveBytesLost = ecrobot::Rs485::getBytesLost();
+	run.slaveBytesCorrupt = ecrobot::Rs485::getBytesCorrupted();
+
+	return NULL;
+}
+
+
+/**************************************************************************************
+ * Run
+ **************************************************************************************/
+/** @brief   Run both ends over one cable and print what happened
+ */
+
+void runCable(const char* name, const ecrobot::Rs485::LinkConfig& config, U32 seconds, U32 load)
+{
+	BenchRun run;
+	pthread_t master;
+	pthread_t slave;
+	U32 maxFrames = seconds * 1000 / COMM_PERIOD * load + load;
+
+	run.config = config;
+	run.seconds = seconds;
+	run.load = load;
+	run.stopSending = false;
+	run.stop = false;
+	run.masterLinkMs = run.slaveLinkMs = 0;
+	run.framesSent = 0;
+	run.sentUs.assign(maxFrames, 0);
+	run.recvUs.assign(maxFrames, 0);
+	run.duplicates = 0;
+	run.badFrames = 0;
+	run.masterPosts = run.slavePosts = 0;
+	run.masterMsgs = 0;
+	run.slaveMsgs = 0;
+	p_Run = &run;
+
+	ecrobot::Rs485::Configure(config);
+
+	if (!ecrobot::Rs485::CreateLink())
+	{
+		printf("%s: could not make the link\n", name);
+		return;
+	}
+
+	pthread_create(&master, NULL, masterThread, &run);
+	pthread_create(&slave, NULL, slaveThread, &run);
+
+	NNxt::sleep(seconds * 1000);
+	run.stopSending = true;
+	NNxt::sleep(DRAIN_TIME + 2 * config.latency);
+	run.stop = true;
+
+	pthread_join(master, NULL);
+	pthread_join(slave, NULL);
+
+	//Throughput and latency of the numbered frames
+	std::vector<double> latency;
+	std::vector<double> recovery;
+	U32 received = 0;
+	uint64_t firstSent = (run.framesSent > 0) ? run.sentUs[0] : 0;
+	uint64_t lastRecv = firstSent;
+
+	for (U32 seq = 0; seq < run.framesSent; seq++)
+	{
+		if (run.recvUs[seq] != 0)
+		{
+			received++;
+			latency.push_back((run.recvUs[seq] - run.sentUs[seq]) / 1000.0);
+			if (run.recvUs[seq] > lastRecv) {lastRecv = run.recvUs[seq];}
+			continue;
+		}
+
+		//First of a run of lost frames, recovered when the next good one arrives
+		if (seq == 0 || run.recvUs[seq - 1] != 0)
+		{
+			U32 next = seq + 1;
+
+			while (next < run.framesSent && run.recvUs[next] == 0) {next++;}
+
+			if (next < run.framesSent)
+			{
+				recovery.push_back((run.recvUs[next] - run.sentUs[seq]) / 1000.0);
+			}
+		}
+	}
+
+	std::sort(latency.begin(), latency.end());
+	std::sort(recovery.begin(), recovery.end());
+
+	double span = (lastRecv > firstSent) ? (lastRecv - firstSent) / 1e6 : 1;
+	double wireBytes = 0;
+
+	//Bytes each frame and message took on the wire, leaving out escapes
+	wireBytes += (double) run.masterStats.msgsSent + run.slaveStats.msgsSent;
+	wireBytes += (double) (run.masterStats.framesSent + run.slaveStats.framesSent) * (1 + MessageClass::HEADER_LENGTH + sizeof(BenchFrame) + 1);
+
+	double recoveryMean = 0;
+	for (U32 n = 0; n < recovery.size(); n++) {recoveryMean += recovery[n] / recovery.size();}
+
+	printf("%s: %u baud, %u ms latency, %u/1000 lost, %u/1000 corrupt, %u s, %u frames per poll\n", name,
+		   config.baud, config.latency, config.lossPPT, config.corruptPPT, seconds, load);
+	printf("  handshake        master %u ms, slave %u ms, %u wakes sent again\n",
+		   run.masterLinkMs, run.slaveLinkMs, run.slaveStats.retransmits);
+	printf("  throughput       %u of %u frames (%.2f%%), %.1f frames/s, %.0f payload bytes/s",
+		   received, run.framesSent, run.framesSent ? 100.0 * received / run.framesSent : 0.0,
+		   received / span, received * sizeof(BenchFrame) / span);
+
+	if (config.baud > 0)
+	{
+		printf(", %.0f%% of the line offered", 100.0 * wireBytes / (run.seconds + DRAIN_TIME / 1000.0) / (config.baud / 10.0));
+	}
+
+	printf("\n");
+	printf("  simple messages  %u of %u to the slave, %u of %u to the master\n",
+		   run.masterMsgs, run.masterPosts, run.slaveMsgs, run.slavePosts);
+	printf("  frame latency    p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+		   percentile(latency, 50), percentile(latency, 90), percentile(latency, 99),
+		   latency.empty() ? 0.0 : latency.back());
+	printf("  ping round trip  master p50 %u ms, p99 %u ms, max %u ms, %u lost; slave p50 %u ms, p99 %u ms, max %u ms, %u lost\n",
+		   run.masterStats.rttP50, run.masterStats.rttP99, run.masterStats.rttMax, run.masterStats.pingsLost,
+		   run.slaveStats.rttP50, run.slaveStats.rttP99, run.slaveStats.rttMax, run.slaveStats.pingsLost);
+	printf("  recovery         %u runs of lost frames, mean %.2f ms, p90 %.2f ms, max %.2f ms\n",
+		   (U32) recovery.size(), recoveryMean, percentile(recovery, 90),
+		   recovery.empty() ? 0.0 : recovery.back());
+	printf("  cable            %u bytes lost and %u corrupted from the master, %u and %u from the slave\n",
+		   run.masterBytesLost, run.masterBytesCorrupt, run.slaveBytesLost, run.slaveBytesCorrupt);
+	printf("  receiver         slave %u CRC errors, %u resyncs; master %u CRC errors, %u resyncs; %u duplicates, %u bad frames past the CRC\n\n",
+		   run.slaveStats.crcErrors, run.slaveStats.resyncs, run.masterStats.crcErrors, run.masterStats.resyncs,
+		   run.duplicates, run.badFrames);
+
+	p_Run = NULL;
+}
+
+
+/**************************************************************************************
+ * Main
+ **************************************************************************************/
+
+int main(int argc, char** argv)
+{
+	ecrobot::Rs485::LinkConfig config;
+	U32 seconds = DEFAULT_SECONDS;
+	U32 load = DEFAULT_LOAD;
+
+	if (argc == 1)
+	{
+		for (U8 n = 0; n < NUM_CABLES; n++)
+		{
+			runCable(Cables[n].name, Cables[n].config, seconds, load);
+		}
+
+		return 0;
+	}
+
+	if (argc < 5)
+	{
+		printf("usage: %s [baud latency_ms loss_ppt corrupt_ppt [seconds [frames_per_poll]]]\n", argv[0]);
+		return 1;
+	}
+
+	config.baud = (U32) atoi(argv[1]);
+	config.latency = (U32) atoi(argv[2]);
+	config.lossPPT = (U16) atoi(argv[3]);
+	config.corruptPPT = (U16) atoi(argv[4]);
+
+	if (argc > 5) {seconds = (U32) atoi(argv[5]);}
+	if (argc > 6) {load = (U32) atoi(argv[6]);}
+
+	runCable("Cable", config, seconds, load);
+
+	return 0;
+}
@@ -0,0 +1,979 @@
+//*************************************************************************************
+/** @file    CommEngine.cpp
+ *  @brief   Cpp file for the communication engine
+ *  @details Handles the handshake, framing and dispatching of messages on the
+ * 			 RS485 link for whichever brick it is running on.
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file, merged from task_MComm.cpp and task_SComm.cpp
+ *	  \li 10-18-2026 ARB Added link statistics
+ *	  \li 10-18-2026 ARB Round trip time histogram reaches past the ping timeout
+ *	  \li 10-18-2026 ARB Tells the other tasks when the statistics page has the screen
+ *	  \li 10-18-2026 ARB Frames are built in BuildFrame(), apart from sending them
+ *	  \li 10-18-2026 ARB Poll() sends the whole queue, not just the first 16 messages
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+#ifdef HOST_BUILD
+#include <cstring>
+#else
+#include "../../yagarto-old/arm-none-eabi/include/c++/4.6.2/cstring"
+#endif
+
+//Need header file for the class
+#include "CommEngine.hpp"
+
+//Needed for timer and sleep functions (Lcd and NNxt come from HostOS.hpp on a PC)
+#ifndef HOST_BUILD
+#include <Lcd.h>
+#include "../../nxtOSEK/NXtpandedLib/src/NNxt.hpp"
+#endif
+#include "ExtraFunctions.hpp"
+
+
+/**************************************************************************************
+ * Constants
+ **************************************************************************************/
+#define COMM_PERIOD    10   //ms between polls of the link
+#define WAKE_POLL      50   //ms between checks for the other brick during the handshake
+#define WAKE_RETRY     500  //ms the slave waits for an ack before sending wake again
+#define FRAME_TIMEOUT  50   //ms a frame may take to arrive before it is dropped
+#define CRC8_POLY      0x07 //x^8 + x^2 + x + 1
+#define ESCAPE_FLIP    0x20 //XORed with a byte that follows idFrameEscape
+#define PING_PERIOD    1000 //ms between pings once the link is up
+#define PING_TIMEOUT   250  //ms to wait for a pong before the ping counts as lost
+#define RTT_FINE_BINS  16   //The round trip time histogram has this many narrow bins,
+#define RTT_FINE_MS    2    //each this many ms wide,
+#define RTT_COARSE_MS  16   //then wide ones up to 288 ms, past PING_TIMEOUT plus a poll
+#define STATS_PAGE_PERIOD 500 //ms between redraws of the statistics page
+
+//Position of each field in a frame header, same order as MessageClass::HeaderData
+#define HDR_TYPE 0
+#define HDR_LEN  1
+#define HDR_ID   2
+
+//The LCD belongs to whichever brick this is running on
+extern ecrobot::Lcd Display;
+
+
+/**************************************************************************************
+ * Constructor
+ **************************************************************************************/
+/** @brief  Class constructor
+ *  @details Only stores where messages come from and go to, nothing is sent
+ * 			 until @c Handshake() is called.
+ * 	@param   role         Which end of the link this is
+ * 	@param   p_TxQueue    Queue of simple message IDs waiting to be sent
+ * 	@param   p_RxMsgID    Mailbox share which receives the ID of each simple message
+ * 	@param   p_RxMsgReady Mailbox flag which is set when a new ID is in @c p_RxMsgID
+ */
+
+CommEngine::CommEngine(commRole role, TaskQueue<CommTxMsg>* p_TxQueue, TaskShare<U8>* p_RxMsgID, TaskShare<bool>* p_RxMsgReady)
+{
+	Role = role;
+
+	this -> p_TxQueue = p_TxQueue;
+	this -> p_RxMsgID = p_RxMsgID;
+	this -> p_RxMsgReady = p_RxMsgReady;
+	p_MsgHandler = NULL;
+	p_FrameHandler = NULL;
+
+	Linked = false;
+
+	rxState = RX_HUNT;
+	rxCount = 0;
+	rxEscape = false;
+	rxStartTime = 0;
+
+	memset(&Stats, 0, sizeof(Stats));
+	memset(rttHist, 0, sizeof(rttHist));
+	pingOut = false;
+	pingTime = 0;
+
+	memset(&PeerStats, 0, sizeof(PeerStats));
+	PeerStatsValid = false;
+
+	statsPage = false;
+	p_StatsPageOn = NULL;
+	buttonWasDown = false;
+	statsPageTime = 0;
+
+	curLine = 1;
+}
+
+
+/**************************************************************************************
+ * Set Message Handler
+ **************************************************************************************/
+/** @brief   Replace the mailbox with a handler function
+ *  @details By default simple messages are posted to the mailbox shares. If a
+ * 			 handler is set it is called instead, from the comm task.
+ * 			 Link messages (wake and ack) are always handled by the engine.
+ *  @param   p_handler Function to call, or NULL to go back to the mailbox
+ */
+
+void CommEngine::setMsgHandler(msgHandler p_handler)
+{
+	p_MsgHandler = p_handler;
+}
+
+
+/**************************************************************************************
+ * Set Frame Handler
+ **************************************************************************************/
+/** @brief   Set the function which handles received frames
+ *  @details Frames are dropped if no handler is set. The data pointer is only
+ * 			 valid until the handler returns.
+ *  @param   p_handler Function to call, or NULL to drop frames
+ */
+
+void CommEngine::setFrameHandler(frameHandler p_handler)
+{
+	p_FrameHandler = p_handler;
+}
+
+
+/**************************************************************************************
+ * Set Stats Page Flag
+ **************************************************************************************/
+/** @brief   Set a share which is true while the statistics page has the screen
+ *  @details The page takes the whole screen. Tasks that write to the screen
+ * 			 check the share first, so they don't draw over it.
+ *  @param   p_flag The share, or NULL for none
+ */
+
+void CommEngine::setStatsPageFlag(TaskShare<bool>* p_flag)
+{
+	p_StatsPageOn = p_flag;
+
+	if (p_StatsPageOn != NULL)
+	{
+		p_StatsPageOn -> put(statsPage);
+	}
+}
+
+
+/**************************************************************************************
+ * Post
+ **************************************************************************************/
+/** @brief   Queue a simple message to be sent to the other brick
+ *  @details Safe to call from any task. The message goes out the next time
+ * 			 the comm task polls the link.
+ *  @param   dID The message to send
+ *  @return  False if the queue was full and the message was not queued
+ */
+
+bool CommEngine::Post(MessageClass::comDataID dID)
+{
+	CommTxMsg msg;
+	bool queued;
+
+	msg.dID = (U8) dID;
+	msg.postTick = NNxt::getTick();
+
+	//Same critical section as the queue so the counters match what went in
+	SuspendAllInterrupts();
+
+	queued = p_TxQueue -> ISR_put(msg);
+
+	if (queued == false)
+	{
+		Stats.txDropped++;
+	}
+	else if (p_TxQueue -> num_items_in() > Stats.txQueueMax)
+	{
+		Stats.txQueueMax = p_TxQueue -> num_items_in();
+	}
+
+	ResumeAllInterrupts();
+
+	return queued;
+}
+
+
+/**************************************************************************************
+ * Send Frame
+ **************************************************************************************/
+/** @brief   Send a frame to the other brick
+ *  @details Builds the whole frame in one buffer so it goes out in a single
+ * 			 send. Only call this from the comm task (for example from a handler)
+ * 			 so that it can't be interleaved with other bytes on the link.
+ *  @param   data  Data to send
+ *  @param   dType The type of data, specified by the @c comDatatype enum
+ *  @param   dID   The data identifier, specified by the @c comDataID enum
+ *  @param   len   Number of data bytes, at most @c MAX_FRAME_DATA
+ *  @return  False if the data was too long to send
+ */
+
+bool CommEngine::SendFrame(U8* data, MessageClass::comDatatype dType, MessageClass::comDataID dID, U8 len)
+{
+	U8 frame[MAX_FRAME_BYTES];
+	U8 frameLen;
+
+	if (len > MAX_FRAME_DATA)
+	{
+		return false;
+	}
+
+	frameLen = BuildFrame(frame, data, dType, dID, len);
+
+	MsgComm.send(frame, 0, frameLen);
+	Stats.framesSent++;
+
+	return true;
+}
+
+
+/**************************************************************************************
+ * Handshake
+ **************************************************************************************/
+/** @brief   Wake up the link
+ *  @details The slave sends a wake message until the master acknowledges it. The
+ * 			 master waits for the wake message and acknowledges it. Either way this
+ * 			 returns once both bricks know the other is alive.
+ */
+
+void CommEngine::Handshake(void)
+{
+	U32 lastWake = NNxt::getTick() - WAKE_RETRY;
+	bool firstWake = true;
+
+	while (Linked == false)
+	{
+		if (Role == roleSlave && NNxt::getTick() - lastWake >= WAKE_RETRY)
+		{
+			//Every wake after the first means the master didn't answer
+			if (firstWake == false)
+			{
+				Stats.retransmits++;
+			}
+
+			SendNow(MessageClass::idWakeMsg);
+			lastWake = NNxt::getTick();
+			firstWake = false;
+		}
+
+		Poll();
+
+		if (Linked == false)
+		{
+			NNxt::sleep(WAKE_POLL);
+		}
+	}
+}
+
+
+/**************************************************************************************
+ * Poll
+ **************************************************************************************/
+/** @brief   Service the link once
+ *  @details Reads everything that has arrived and dispatches it, then sends
+ * 			 everything waiting in the queue, up to 16 messages per send. Once the link is up it also sends
+ * 			 a ping when one is due.
+ */
+
+void CommEngine::Poll(void)
+{
+	U8 chunk[16];
+	U32 n;
+	U8 len = 0;
+	CommTxMsg msg;
+	U32 now;
+
+	//Drop a frame that stalled part way through and look for the next one
+	if (rxState != RX_HUNT && NNxt::getTick() - rxStartTime > FRAME_TIMEOUT)
+	{
+		rxState = RX_HUNT;
+		Stats.resyncs++;
+	}
+
+	//Read everything that is waiting
+	while ((n = MsgComm.receive(chunk, 0, sizeof(chunk))) > 0)
+	{
+		for (U32 i = 0; i < n; i++)
+		{
+			RxByte(chunk[i]);
+		}
+	}
+
+	//Send everything that is waiting, a chunk at a time
+	now = NNxt::getTick();
+
+	while (p_TxQueue -> get(msg))
+	{
+		chunk[len++] = msg.dID;
+
+		if (now - msg.postTick > Stats.maxQueueDelay)
+		{
+			Stats.maxQueueDelay = (now - msg.postTick > 0xFFFF) ? 0xFFFF : (U16) (now - msg.postTick);
+		}
+
+		if (len == sizeof(chunk))
+		{
+			MsgComm.send(chunk, 0, len);
+			Stats.msgsSent += len;
+			len = 0;
+		}
+	}
+
+	if (len > 0)
+	{
+		MsgComm.send(chunk, 0, len);
+		Stats.msgsSent += len;
+	}
+
+	if (Linked)
+	{
+		Ping();
+	}
+}
+
+
+/**************************************************************************************
+ * Run
+ **************************************************************************************/
+/** @brief   Service the link forever
+ *  @details Polls the link every @c COMM_PERIOD ms and looks after the
+ * 			 statistics page. Never returns.
+ */
+
+void CommEngine::Run(void)
+{
+	U32 currentTime;
+
+	//Go forever!
+	while(true)
+	{
+		currentTime = NNxt::getTick();
+
+		Poll();
+
+		CheckStatsPage();
+
+		//Let other tasks run
+		sleep_from_for(currentTime, COMM_PERIOD);
+	}
+}
+
+
+/**************************************************************************************
+ * Send Now
+ **************************************************************************************/
+/** @brief   Send a simple message right away
+ *  @details Used for link messages which must not wait behind the queue. Only
+ * 			 call this from the comm task.
+ *  @param   dID The message to send
+ */
+
+void CommEngine::SendNow(MessageClass::comDataID dID)
+{
+	U8 msg = (U8) dID;
+
+	MsgComm.send(&msg, 0, 1);
+	Stats.msgsSent++;
+}
+
+
+/**************************************************************************************
+ * Ping
+ **************************************************************************************/
+/** @brief   Keep one ping going to measure the round trip time
+ *  @details A ping with no pong after @c PING_TIMEOUT ms is counted as lost,
+ * 			 and a new one is sent every @c PING_PERIOD ms.
+ */
+
+void CommEngine::Ping(void)
+{
+	U32 now = NNxt::getTick();
+
+	if (pingOut && now - pingTime > PING_TIMEOUT)
+	{
+		Stats.pingsLost++;
+		pingOut = false;
+	}
+
+	if (pingOut == false && now - pingTime >= PING_PERIOD)
+	{
+		SendNow(MessageClass::idPing);
+		pingTime = now;
+		pingOut = true;
+	}
+}
+
+
+/**************************************************************************************
+ * Receive Byte
+ **************************************************************************************/
+/** @brief   Run one received byte through the framing state machine
+ *  @details Outside a frame each byte is a simple message. A frame start byte
+ * 			 switches to collecting the header, data and checksum. A start byte
+ * 			 in the middle of a frame means part of that frame was lost, so it is
+ * 			 dropped and the new frame is collected instead. If the header can't
+ * 			 be right the frame is dropped and the engine waits for the next start.
+ *  @param   byte The byte that was received
+ */
+
+void CommEngine::RxByte(U8 byte)
+{
+	//A start byte always begins a new frame
+	if (byte == MessageClass::idFrameStart)
+	{
+		//Part of the last frame was lost
+		if (rxState != RX_HUNT)
+		{
+			Stats.resyncs++;
+		}
+
+		rxState = RX_HEADER;
+		rxCount = 0;
+		rxEscape = false;
+		rxStartTime = NNxt::getTick();
+		return;
+	}
+
+	//Undo escaping inside a frame
+	if (rxState != RX_HUNT)
+	{
+		if (byte == MessageClass::idFrameEscape)
+		{
+			rxEscape = true;
+			return;
+		}
+
+		if (rxEscape)
+		{
+			byte ^= ESCAPE_FLIP;
+			rxEscape = false;
+		}
+	}
+
+	switch (rxState)
+	{
+		case RX_HUNT:
+
+			if (byte != MessageClass::idNoMsg && byte != MessageClass::idFrameEscape)
+			{
+				Stats.msgsRecv++;
+				Dispatch(static_cast<MessageClass::comDataID> (byte));
+			}
+
+			break;
+
+		case RX_HEADER:
+
+			rxBuf[rxCount++] = byte;
+
+			if (rxCount == MessageClass::HEADER_LENGTH)
+			{
+				if (rxBuf[HDR_LEN] > MAX_FRAME_DATA)
+				{
+					rxState = RX_HUNT;
+					Stats.resyncs++;
+				}
+				else
+				{
+					rxState = (rxBuf[HDR_LEN] > 0) ? RX_DATA : RX_CRC;
+				}
+			}
+
+			break;
+
+		case RX_DATA:
+
+			rxBuf[rxCount++] = byte;
+
+			if (rxCount == MessageClass::HEADER_LENGTH + rxBuf[HDR_LEN])
+			{
+				rxState = RX_CRC;
+			}
+
+			break;
+
+		case RX_CRC:
+
+			rxState = RX_HUNT;
+
+			if (CRC8(0, rxBuf, rxCount) != byte)
+			{
+				Stats.crcErrors++;
+				break;
+			}
+
+			Stats.framesRecv++;
+
+			//The other brick's counters are kept here, everything else goes to the handler
+			if (rxBuf[HDR_ID] == MessageClass::idStatsReport && rxBuf[HDR_LEN] == sizeof(LinkStats))
+			{
+				SuspendAllInterrupts();
+				memcpy(&PeerStats, &rxBuf[MessageClass::HEADER_LENGTH], sizeof(LinkStats));
+				PeerStatsValid = true;
+				ResumeAllInterrupts();
+			}
+			else if (p_FrameHandler != NULL)
+			{
+				p_FrameHandler(static_cast<MessageClass::comDatatype> (rxBuf[HDR_TYPE]),
+							   static_cast<MessageClass::comDataID> (rxBuf[HDR_ID]),
+							   &rxBuf[MessageClass::HEADER_LENGTH], rxBuf[HDR_LEN]);
+			}
+
+			break;
+	}
+}
+
+
+/**************************************************************************************
+ * Dispatch
+ **************************************************************************************/
+/** @brief   Handle a simple message
+ *  @details Wake and ack messages are part of the handshake and are handled here.
+ * 			 A wake message after the handshake means the slave missed the ack,
+ * 			 so it is acknowledged again. Pings and requests for statistics are
+ * 			 answered here too. Everything else goes to the handler or the mailbox.
+ *  @param   dID The message that was received
+ */
+
+void CommEngine::Dispatch(MessageClass::comDataID dID)
+{
+	switch (dID)
+	{
+		case MessageClass::idWakeMsg:
+
+			if (Role == roleMaster)
+			{
+				SendNow(MessageClass::idAckMsg);
+				Linked = true;
+			}
+
+			break;
+
+		case MessageClass::idAckMsg:
+
+			if (Role == roleSlave)
+			{
+				Linked = true;
+			}
+
+			break;
+
+		case MessageClass::idPing:
+
+			SendNow(MessageClass::idPong);
+
+			break;
+
+		case MessageClass::idPong:
+
+			//A pong after the ping timed out has already been counted as lost
+			if (pingOut)
+			{
+				U32 rtt = NNxt::getTick() - pingTime;
+				U32 bin = (rtt < RTT_FINE_BINS * RTT_FINE_MS) ? rtt / RTT_FINE_MS :
+						  RTT_FINE_BINS + (rtt - RTT_FINE_BINS * RTT_FINE_MS) / RTT_COARSE_MS;
+
+				//Slower than the histogram goes, only counted
+				if (bin >= RTT_BINS)
+				{
+					Stats.rttOver++;
+				}
+				else
+				{
+					rttHist[bin]++;
+				}
+
+				if (rtt > Stats.rttMax)
+				{
+					Stats.rttMax = (rtt > 0xFFFF) ? 0xFFFF : (U16) rtt;
+				}
+
+				pingOut = false;
+			}
+
+			break;
+
+		case MessageClass::idStatsRequest:
+		{
+			LinkStats stats = GetStats();
+
+			SendFrame((U8*) &stats, MessageClass::typeRaw, MessageClass::idStatsReport, sizeof(stats));
+
+			break;
+		}
+
+		default:
+
+			if (p_MsgHandler != NULL)
+			{
+				p_MsgHandler(dID);
+			}
+			else
+			{
+				p_RxMsgID -> put((U8) dID);
+				p_RxMsgReady -> put(true);
+			}
+
+			break;
+	}
+}
+
+
+/**************************************************************************************
+ * Get Stats
+ **************************************************************************************/
+/** @brief   Read this end's link counters
+ *  @details The counters are copied in a critical section so they all come from
+ * 			 the same moment. The round trip time percentiles are the top of the
+ * 			 histogram bin they fall in, so they are rounded up to the bin width:
+ * 			 @c RTT_FINE_MS below 32 ms and @c RTT_COARSE_MS above.
+ *  @return  Copy of the counters
+ */
+
+CommEngine::LinkStats CommEngine::GetStats(void)
+{
+	LinkStats stats;
+
+	SuspendAllInterrupts();
+
+	stats = Stats;
+	stats.txQueueDepth = p_TxQueue -> num_items_in();
+	stats.rttP50 = RttPercentile(50);
+	stats.rttP90 = RttPercentile(90);
+	stats.rttP99 = RttPercentile(99);
+
+	ResumeAllInterrupts();
+
+	return stats;
+}
+
+
+/**************************************************************************************
+ * Request Peer Stats
+ **************************************************************************************/
+/** @brief   Ask the other brick for its link counters
+ *  @details The answer arrives later as an @c idStatsReport frame. Read it
+ * 			 with @c GetPeerStats().
+ *  @return  False if the request could not be queued
+ */
+
+bool CommEngine::RequestPeerStats(void)
+{
+	return Post(MessageClass::idStatsRequest);
+}
+
+
+/**************************************************************************************
+ * Get Peer Stats
+ **************************************************************************************/
+/** @brief   Read the link counters last reported by the other brick
+ *  @param   stats Where the counters are copied
+ *  @return  False if the other brick hasn't reported yet
+ */
+
+bool CommEngine::GetPeerStats(LinkStats& stats)
+{
+	bool valid;
+
+	SuspendAllInterrupts();
+
+	valid = PeerStatsValid;
+	stats = PeerStats;
+
+	ResumeAllInterrupts();
+
+	return valid;
+}
+
+
+/**************************************************************************************
+ * Show Stats
+ **************************************************************************************/
+/** @brief   Draw the link counters on the screen
+ *  @details Takes over the whole screen, this end in the first column and the
+ * 			 other brick in the second. The peer column is left empty until the
+ * 			 other brick has reported.
+ */
+
+void CommEngine::ShowStats(void)
+{
+	LinkStats me = GetStats();
+	LinkStats peer;
+	bool peerValid = GetPeerStats(peer);
+
+	const char* names[] = {"TxF ", "RxF ", "CRC ", "Rsy ", "Rtx ", "Dly ", "R90 "};
+	U32 mine[] = {me.framesSent, me.framesRecv, me.crcErrors, me.resyncs, me.retransmits, me.maxQueueDelay, me.rttP90};
+	U32 theirs[] = {peer.framesSent, peer.framesRecv, peer.crcErrors, peer.resyncs, peer.retransmits, peer.maxQueueDelay, peer.rttP90};
+
+	Display.clear();
+	Display.cursor(0,0);
+	Display.putf("s\n", "Link   me  peer");
+
+	for (U8 row = 0; row < sizeof(names) / sizeof(names[0]); row++)
+	{
+		if (peerValid)
+		{
+			Display.putf("sdsd\n", names[row], mine[row],5, " ", theirs[row],5);
+		}
+		else
+		{
+			Display.putf("sd\n", names[row], mine[row],5);
+		}
+	}
+
+	Display.disp();
+}
+
+
+/**************************************************************************************
+ * Count Retransmit
+ **************************************************************************************/
+/** @brief   Add to the retransmit counter
+ *  @details For transfers built on top of the engine, like the slave tuning
+ * 			 download, which do their own retries.
+ */
+
+void CommEngine::CountRetransmit(void)
+{
+	Stats.retransmits++;
+}
+
+
+/**************************************************************************************
+ * Check Stats Page
+ **************************************************************************************/
+/** @brief   Show the statistics page while it is turned on
+ *  @details Each press of the enter button turns the page on or off. While it
+ * 			 is on it is redrawn every @c STATS_PAGE_PERIOD ms, and the other
+ * 			 brick is asked for new counters each time. The share set with
+ * 			 @c setStatsPageFlag() follows the page, so other tasks keep off
+ * 			 the screen. When the page is turned off the screen is cleared, and
+ * 			 their lines come back as they next write them.
+ */
+
+void CommEngine::CheckStatsPage(void)
+{
+	bool buttonDown = (ecrobot_is_ENTER_button_pressed() != 0);
+	U32 now = NNxt::getTick();
+
+	if (buttonDown && buttonWasDown == false)
+	{
+		statsPage = !statsPage;
+		statsPageTime = now - STATS_PAGE_PERIOD;
+
+		if (p_StatsPageOn != NULL)
+		{
+			p_StatsPageOn -> put(statsPage);
+		}
+
+		if (statsPage == false)
+		{
+			Display.clear();
+			Display.disp();
+		}
+	}
+
+	buttonWasDown = buttonDown;
+
+	if (statsPage && now - statsPageTime >= STATS_PAGE_PERIOD)
+	{
+		RequestPeerStats();
+		ShowStats();
+		statsPageTime = now;
+	}
+}
+
+
+/**************************************************************************************
+ * RTT Percentile
+ **************************************************************************************/
+/** @brief   Find the round trip time which a share of the pings came back within
+ *  @details Pongs slower than the histogram goes count towards the total, so
+ * 			 a percentile that falls among them gives the longest time seen.
+ *  @param   percent Share of the pings, from 1 to 100
+ *  @return  Top of the histogram bin the percentile falls in, but no more than
+ * 			 the longest time seen, in ms. 0 if no pings have come back yet.
+ */
+
+U16 CommEngine::RttPercentile(U8 percent)
+{
+	U32 total = Stats.rttOver;
+	U32 count = 0;
+	U32 target;
+	U32 top;
+
+	for (U8 bin = 0; bin < RTT_BINS; bin++)
+	{
+		total += rttHist[bin];
+	}
+
+	if (total == 0)
+	{
+		return 0;
+	}
+
+	//Round up so a small number of pings still picks a bin that has some
+	target = (total * percent + 99) / 100;
+
+	for (U8 bin = 0; bin < RTT_BINS; bin++)
+	{
+		count += rttHist[bin];
+
+		if (count >= target)
+		{
+			top = (bin < RTT_FINE_BINS) ? (bin + 1) * RTT_FINE_MS :
+				  RTT_FINE_BINS * RTT_FINE_MS + (bin + 1 - RTT_FINE_BINS) * RTT_COARSE_MS;
+
+			//None of them took longer than the longest seen
+			return (top < Stats.rttMax) ? (U16) top : Stats.rttMax;
+		}
+	}
+
+	return Stats.rttMax;
+}
+
+
+/**************************************************************************************
+ * Build Frame
+ **************************************************************************************/
+/** @brief   Put a whole frame in a buffer, ready to send
+ *  @details The start byte, then the header, data and checksum with each byte
+ * 			 escaped as needed.
+ *  @param   p_frame Buffer for the frame, at least @c MAX_FRAME_BYTES long
+ *  @param   data    Data to send
+ *  @param   dType   The type of data, specified by the @c comDatatype enum
+ *  @param   dID     The data identifier, specified by the @c comDataID enum
+ *  @param   len     Number of data bytes, at most @c MAX_FRAME_DATA
+ *  @return  Number of bytes in the frame
+ */
+
+U8 CommEngine::BuildFrame(U8* p_frame, const U8* data, MessageClass::comDatatype dType, MessageClass::comDataID dID, U8 len)
+{
+	U8 header[MessageClass::HEADER_LENGTH];
+	U8 frameLen = 0;
+	U8 crc;
+
+	header[HDR_TYPE] = (U8) dType;
+	header[HDR_LEN] = len;
+	header[HDR_ID] = (U8) dID;
+
+	crc = CRC8(0, header, MessageClass::HEADER_LENGTH);
+	crc = CRC8(crc, data, len);
+
+	p_frame[frameLen++] = MessageClass::idFrameStart;
+
+	for (U8 i = 0; i < MessageClass::HEADER_LENGTH; i++)
+	{
+		frameLen = Stuff(p_frame, frameLen, header[i]);
+	}
+
+	for (U8 i = 0; i < len; i++)
+	{
+		frameLen = Stuff(p_frame, frameLen, data[i]);
+	}
+
+	return Stuff(p_frame, frameLen, crc);
+}
+
+
+/**************************************************************************************
+ * Stuff
+ **************************************************************************************/
+/** @brief   Add a byte to a frame being built
+ *  @details The start and escape bytes are replaced by the escape byte and the
+ * 			 original with bit 5 flipped.
+ *  @param   p_frame Frame being built
+ *  @param   len     Number of bytes already in the frame
+ *  @param   byte    Byte to add
+ *  @return  New number of bytes in the frame
+ */
+
+U8 CommEngine::Stuff(U8* p_frame, U8 len, U8 byte)
+{
+	if (byte == MessageClass::idFrameStart || byte == MessageClass::idFrameEscape)
+	{
+		p_frame[len++] = MessageClass::idFrameEscape;
+		byte ^= ESCAPE_FLIP;
+	}
+
+	p_frame[len++] = byte;
+
+	return len;
+}
+
+
+/**************************************************************************************
+ * CRC-8
+ **************************************************************************************/
+/** @brief   Calculate a CRC-8 over a block of bytes
+ *  @param   crc  Starting value, 0 for a new calculation
+ *  @param   data Bytes to include
+ *  @param   len  Number of bytes
+ *  @return  The updated CRC
+ */
+
+U8 CommEngine::CRC8(U8 crc, const U8* data, U8 len)
+{
+	for (U8 i = 0; i < len; i++)
+	{
+		crc ^= data[i];
+
+		for (U8 bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x80) ? (U8) ((crc << 1) ^ CRC8_POLY) : (U8) (crc << 1);
+		}
+	}
+
+	return crc;
+}
+
+
+/**************************************************************************************
+ * Easy functions to write debug msgs
+ **************************************************************************************/
+/** @brief   Write sequential debug msgs
+ *  @details These functions write messages on the screen one line
+ * 			 at a time and then loop back and erase old stuff after a while.
+ * @param    msg The message to write
+ */
+
+void CommEngine::debug(const char* msg)
+{
+	Display.clearRow(curLine);
+	Display.cursor(0,curLine);
+	Display.putf("s\n", msg);
+	Display.disp();
+
+	curLine++;
+	if(curLine > 7) curLine = 1;
+}
+
+
+/** @brief   Write a message number and direction
+ * @param    msg The message ID to write
+ * @param    dir 1 if the message was sent, 0 if it was received
+ */
+
+void CommEngine::debugnum(U8 msg, U8 dir)
+{
+	Display.clearRow(curLine);
+	Display.cursor(0,curLine);
+	Display.putf("dsd\n", msg,0, ",", dir,0);
+	Display.disp();
+
+	curLine++;
+	if(curLine > 7) curLine = 1;
+}
@@ -0,0 +1,244 @@
+//*************************************************************************************
+/** @file    CommEngine.hpp
+ *  @brief   Communication engine shared by the Master and Slave comm tasks
+ *  @details Both bricks talk over the same RS485 link with the same protocol, so
+ * 			 the link handling lives here once instead of in each comm task.
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file, merged from task_MComm.cpp and task_SComm.cpp
+ *	  \li 10-18-2026 ARB Added link statistics
+ *	  \li 10-18-2026 ARB Round trip time histogram reaches past the ping timeout
+ *	  \li 10-18-2026 ARB Tells the other tasks when the statistics page has the screen
+ *	  \li 10-18-2026 ARB Frames are built in BuildFrame(), apart from sending them
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _COMMENGINE_H_
+#define _COMMENGINE_H_
+
+#include "taskshare.hpp"
+#include "taskqueue.hpp"
+#include "MessageClass.hpp"
+
+//One simple message waiting in the transmit queue
+struct CommTxMsg
+{
+	U8  dID;      /**<The message, a MessageClass::comDataID*/
+	U32 postTick; /**<System tick when it was posted, for the queueing delay*/
+};
+
+/**************************************************************************************
+ * Comm Engine class
+ **************************************************************************************/
+/** @brief  Runs one end of the RS485 link between the two bricks.
+ *  @details The engine wakes up the link, then polls it forever. Every byte that
+ * 			 comes in is either a simple message (a single @c comDataID byte) or
+ * 			 part of a frame. A frame is the @c idFrameStart byte, a @c MessageClass
+ * 			 header, the data, and a CRC-8 of the header and data. Inside a frame
+ * 			 the start and escape bytes are sent as @c idFrameEscape followed by the
+ * 			 byte with bit 5 flipped, so a start byte on the wire always means a new
+ * 			 frame and the receiver can find its way back after a lost byte.
+ *
+ * 			 Everything that changes between the bricks is handed in:
+ * 			 \li The role decides who announces itself during the handshake.
+ * 			 \li Outgoing simple messages are read from a @c TaskQueue.
+ * 			 \li Incoming simple messages are posted to a mailbox of shares, or to a
+ * 				 handler function if one is set.
+ * 			 \li Incoming frames are passed to a handler function.
+ *
+ * 			 The engine also keeps counters of how the link is doing (see
+ * 			 @c LinkStats). Once linked it pings the other brick every second to
+ * 			 measure the round trip time, and answers an @c idStatsRequest with
+ * 			 its own counters in an @c idStatsReport frame.
+ */
+
+
+class CommEngine
+{
+
+public:
+
+	//Which end of the link this engine runs on
+	enum commRole
+	{
+		roleMaster = 0, /**<Waits for the slave to wake up, then acknowledges it*/
+		roleSlave  = 1  /**<Announces itself and waits for the master to acknowledge*/
+	};
+
+	//Largest amount of data a frame can carry
+	static const U8 MAX_FRAME_DATA = 48;
+
+	//Longest a frame can be on the wire, every byte after the start byte escaped
+	static const U8 MAX_FRAME_BYTES = 1 + 2 * (MessageClass::HEADER_LENGTH + MAX_FRAME_DATA + 1);
+
+	//Number of bins in the round trip time histogram
+	static const U8 RTT_BINS = 32;
+
+	//Counters for one end of the link. This is also the data of an idStatsReport frame.
+	struct LinkStats
+	{
+		U32 framesSent;    /**<Frames sent*/
+		U32 framesRecv;    /**<Frames received with a good CRC*/
+		U32 msgsSent;      /**<Simple messages sent, link messages included*/
+		U32 msgsRecv;      /**<Simple messages received, link messages included*/
+		U16 crcErrors;     /**<Frames dropped because the CRC did not match*/
+		U16 resyncs;       /**<Frames dropped part way through: new start byte, timeout or bad length*/
+		U16 retransmits;   /**<Wake messages and transfers sent again because no ack came back*/
+		U16 txDropped;     /**<Posts refused because the transmit queue was full*/
+		U16 pingsLost;     /**<Pings which were not answered in time*/
+		U16 maxQueueDelay; /**<Longest a message has waited in the transmit queue, in ms*/
+		U16 rttP50;        /**<Median round trip time, in ms*/
+		U16 rttP90;        /**<90th percentile round trip time, in ms*/
+		U16 rttP99;        /**<99th percentile round trip time, in ms*/
+		U16 rttMax;        /**<Longest round trip time, in ms*/
+		U16 rttOver;       /**<Pongs slower than the round trip time histogram goes*/
+		U8  txQueueDepth;  /**<Messages in the transmit queue right now*/
+		U8  txQueueMax;    /**<Most messages that have been in the transmit queue at once*/
+	};
+
+	//Function called for each simple message received
+	typedef void (*msgHandler)(MessageClass::comDataID dID);
+
+	//Function called for each frame received with a good checksum
+	typedef void (*frameHandler)(MessageClass::comDatatype dType, MessageClass::comDataID dID, U8* data, U8 len);
+
+	//Constructor
+	CommEngine(commRole role, TaskQueue<CommTxMsg>* p_TxQueue, TaskShare<U8>* p_RxMsgID, TaskShare<bool>* p_RxMsgReady);
+
+	//Replace the default mailbox dispatch of simple messages
+	void setMsgHandler(msgHandler p_handler);
+
+	//Set where received frames are dispatched
+	void setFrameHandler(frameHandler p_handler);
+
+	//Set a share which is true while the statistics page has the screen
+	void setStatsPageFlag(TaskShare<bool>* p_flag);
+
+	//Queue a simple message to be sent (any task)
+	bool Post(MessageClass::comDataID dID);
+
+	//Send a frame right away (comm task only)
+	bool SendFrame(U8* data, MessageClass::comDatatype dType, MessageClass::comDataID dID, U8 len);
+
+	//Wake up the link, returns once the other brick has answered
+	void Handshake(void);
+
+	//Service the link once
+	void Poll(void);
+
+	//Service the link forever
+	void Run(void);
+
+	//Copy of this end's counters (any task)
+	LinkStats GetStats(void);
+
+	//Ask the other brick to send its counters (any task)
+	bool RequestPeerStats(void);
+
+	//Copy of the counters from the other brick's last report, false if none yet (any task)
+	bool GetPeerStats(LinkStats& stats);
+
+	//Draw the counters of both ends on the screen
+	void ShowStats(void);
+
+	//Count a message the caller had to send again (comm task only)
+	void CountRetransmit(void);
+
+	//Write sequential debug messages to the screen
+	void debug(const char* msg);
+	void debugnum(U8 msg, U8 dir);
+
+	//CRC-8 used to protect frames
+	static U8 CRC8(U8 crc, const U8* data, U8 len);
+
+protected:
+
+	//Send a simple message right away, bypassing the queue
+	void SendNow(MessageClass::comDataID dID);
+
+	//Send a ping to measure the round trip time, or give up on the last one
+	void Ping(void);
+
+	//Round trip time below which a share of the pings came back
+	U16 RttPercentile(U8 percent);
+
+	//Start or stop the statistics page when the enter button is pressed
+	void CheckStatsPage(void);
+
+	//Run one received byte through the framing state machine
+	void RxByte(U8 byte);
+
+	//Put a whole frame in a buffer, ready to send
+	static U8 BuildFrame(U8* p_frame, const U8* data, MessageClass::comDatatype dType, MessageClass::comDataID dID, U8 len);
+
+	//Add a byte to a frame being built, escaping it if needed
+	static U8 Stuff(U8* p_frame, U8 len, U8 byte);
+
+	//Handle a complete simple message
+	void Dispatch(MessageClass::comDataID dID);
+
+	//Role of this end of the link
+	commRole Role;
+
+	//Where messages come from and go to
+	TaskQueue<CommTxMsg>* p_TxQueue;
+	TaskShare<U8>* p_RxMsgID;
+	TaskShare<bool>* p_RxMsgReady;
+	msgHandler p_MsgHandler;
+	frameHandler p_FrameHandler;
+
+	//Set once the handshake has seen the other brick answer
+	bool Linked;
+
+	//Receive side of the framing state machine
+	enum rxState_t {RX_HUNT, RX_HEADER, RX_DATA, RX_CRC} rxState;
+	U8  rxBuf[MessageClass::HEADER_LENGTH + MAX_FRAME_DATA];
+	U8  rxCount;
+	bool rxEscape;
+	U32 rxStartTime;
+
+	//Link counters. The round trip time fields are worked out from rttHist when read.
+	LinkStats Stats;
+	U16 rttHist[RTT_BINS];
+
+	//The ping waiting for an answer
+	bool pingOut;
+	U32 pingTime;
+
+	//Counters last reported by the other brick
+	LinkStats PeerStats;
+	bool PeerStatsValid;
+
+	//Statistics page on the screen, and the share other tasks check before writing to it
+	bool statsPage;
+	TaskShare<bool>* p_StatsPageOn;
+	bool buttonWasDown;
+	U32 statsPageTime;
+
+	//Next screen line used by debug()
+	U8 curLine;
+
+};
+
+
+//Fixes weird linker issues....
+#include "CommEngine.cpp"
+
+#endif
@@ -3,9 +3,12 @@
  *  @brief   Some extra functions that can be used for the RoboRodenatia program
  *  @details Included functions:
  * 			 sleep_from_for()
+ * 			 cycle_stamp()
+ * 			 cycles_since()
  *
  *  Revised:    
  *	  \li 02-28-2015 ARB Original file
+ *	  \li 10-18-2026 ARB Added the cycle counter functions
  *
  *  License:
  *	 		
@@ -33,7 +36,27 @@
 /**************************************************************************************
  * Include NXTexpanded Lib Files
  **************************************************************************************/
+#ifdef HOST_BUILD
+#include "HostOS.hpp"
+#else
+extern "C" {
+#include "../../nxtOSEK/toppers_osek/include/kernel.h"
+#include "kernel_id.h"
+#include "../../nxtOSEK/ecrobot/c/ecrobot_interface.h"
+}
 #include "../../nxtOSEK/NXtpandedLib/src/NNxt.hpp"
+#endif
+
+
+/**************************************************************************************
+ * Constants
+ **************************************************************************************/
+//Registers of the AT91SAM7 periodic interval timer, which drives the 1 ms system tick
+#define PIT_MR   (*(volatile U32*) 0xFFFFFD30)
+#define PIT_PIIR (*(volatile U32*) 0xFFFFFD3C)
+
+//CPU clock cycles per count of the timer, which runs at MCK / 16 (about 3 MHz)
+#define CYCLES_PER_STAMP 16
 
 
 
@@ -61,4 +84,59 @@ inline void sleep_from_for(U32 start_time, U32 sleep_time)
 
 
 
+/**************************************************************************************
+ * cycle_stamp
+ **************************************************************************************/
+/** @brief   Read a free running counter for timing short pieces of code
+ *  @details The periodic interval timer counts at MCK / 16 and rolls over every
+ * 			 ms, when the system tick goes up. The stamp is the system tick times
+ * 			 the timer period plus the count within the period, read with
+ * 			 interrupts off so the two agree. Periods which have ended but
+ * 			 haven't been counted by the tick interrupt yet are added in. The
+ * 			 stamp wraps after about 23 minutes, which is fine for differences.
+ * 			 On a PC it is made from the system clock at the same rate.
+ *  @return  The counter, in timer counts (@c CYCLES_PER_STAMP CPU cycles each)
+ */
+
+inline U32 cycle_stamp(void)
+{
+#ifdef HOST_BUILD
+	struct timespec now;
+	
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (U32) ((now.tv_sec * 1000000000ULL + now.tv_nsec) * 3 / 1000);
+#else
+	U32 tick;
+	U32 piir;
+	U32 period;
+	
+	SuspendAllInterrupts();
+	tick = NNxt::getTick();
+	piir = PIT_PIIR;
+	period = (PIT_MR & 0xFFFFF) + 1;
+	ResumeAllInterrupts();
+	
+	return (tick + (piir >> 20)) * period + (piir & 0xFFFFF);
+#endif
+}
+
+
+
+
+/**************************************************************************************
+ * cycles_since
+ **************************************************************************************/
+/** @brief   Find how many CPU cycles have passed since a stamp
+ *  @param   stamp A value from @c cycle_stamp()
+ *  @return  CPU cycles since the stamp, to the nearest @c CYCLES_PER_STAMP
+ */
+
+inline U32 cycles_since(U32 stamp)
+{
+	return (cycle_stamp() - stamp) * CYCLES_PER_STAMP;
+}
+
+
+
+
 #endif
@@ -0,0 +1,229 @@
+//*************************************************************************************
+/** @file    FixedPoint.hpp
+ *  @brief   Fixed point numbers and table based trig for the NXT
+ *  @details The NXT's ARM7 has no FPU, so every float operation is done in
+ * 			 software. This file has the integer versions that the odometry and
+ * 			 controllers use instead:
+ * 			 \li @c Q16, a signed number with 16 fraction bits, and its multiply
+ * 				 and divide, which go through 64 bits so they don't overflow
+ * 			 \li Binary angles, where a full turn is 2^32 so a @c U32 wraps around
+ * 				 by itself
+ * 			 \li @c SinQ16() and @c CosQ16() of a binary angle, from a quarter wave
+ * 				 table with linear interpolation (error below 3e-5)
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *	  \li 10-18-2026 ARB Added Isqrt()
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _FIXEDPOINT_H_
+#define _FIXEDPOINT_H_
+
+#ifdef HOST_BUILD
+#include "HostOS.hpp"
+#else
+extern "C" {
+#include "../../nxtOSEK/ecrobot/c/ecrobot_interface.h"
+}
+#endif
+
+
+/**************************************************************************************
+ * Q16.16 numbers
+ **************************************************************************************/
+//Signed fixed point number with 16 integer bits and 16 fraction bits
+typedef S32 Q16;
+
+#define Q16_SHIFT 16
+#define Q16_ONE   65536
+
+//Convert a whole number to Q16
+#define INT2Q16(n) ((Q16) (n) << Q16_SHIFT)
+
+//Convert a constant to Q16 at compile time. Don't use it on variables, it is a float.
+#define FLOAT2Q16(f) ((Q16) ((f) * Q16_ONE + (((f) < 0) ? -0.5 : 0.5)))
+
+//2*pi in Q16
+#define Q16_TWO_PI 411775
+
+/** @brief   Multiply two Q16 numbers, rounding to nearest
+ */
+inline Q16 Q16mul(Q16 a, Q16 b)
+{
+	return (Q16) (((S64) a * b + (1 << (Q16_SHIFT - 1))) >> Q16_SHIFT);
+}
+
+/** @brief   Divide two Q16 numbers
+ *  @details The caller must make sure @c b isn't 0.
+ */
+inline Q16 Q16div(Q16 a, Q16 b)
+{
+	return (Q16) (((S64) a << Q16_SHIFT) / b);
+}
+
+/** @brief   Round a Q16 number to the nearest whole number
+ */
+inline S32 Q16round(Q16 a)
+{
+	return (a + (1 << (Q16_SHIFT - 1))) >> Q16_SHIFT;
+}
+
+/** @brief   Square root of a whole number, rounded down
+ *  @details One bit of the answer per pass, so it takes 16 passes.
+ */
+inline U32 Isqrt(U32 n)
+{
+	U32 root = 0;
+	U32 bit = 1UL << 30;
+	
+	while (bit > n) {bit >>= 2;}
+	
+	while (bit != 0)
+	{
+		if (n >= root + bit)
+		{
+			n -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+		{
+			root >>= 1;
+		}
+		
+		bit >>= 2;
+	}
+	
+	return root;
+}
+
+
+/**************************************************************************************
+ * Binary angles
+ **************************************************************************************/
+//A full turn as a binary angle is 2^32, so these are the common angles
+#define BAM_90  0x40000000UL
+#define BAM_180 0x80000000UL
+
+//Binary angle units in one degree, 2^32 / 360
+#define BAM_PER_DEGREE 11930465L
+
+/** @brief   Sine of a binary angle
+ *  @param   angle The angle, a full turn is 2^32
+ *  @return  The sine as a Q16
+ */
+inline Q16 SinQ16(U32 angle)
+{
+	//Sine of the first quarter turn in 256 steps, round(65536 * sin(i * pi / 512))
+	static const S32 QuarterSine[257] =
+	{
+		    0,   402,   804,  1206,  1608,  2010,  2412,  2814,
+		 3216,  3617,  4019,  4420,  4821,  5222,  5623,  6023,
+		 6424,  6824,  7224,  7623,  8022,  8421,  8820,  9218,
+		 9616, 10014, 10411, 10808, 11204, 11600, 11996, 12391,
+		12785, 13180, 13573, 13966, 14359, 14751, 15143, 15534,
+		15924, 16314, 16703, 17091, 17479, 17867, 18253, 18639,
+		19024, 19409, 19792, 20175, 20557, 20939, 21320, 21699,
+		22078, 22457, 22834, 23210, 23586, 23961, 24335, 24708,
+		25080, 25451, 25821, 26190, 26558, 26925, 27291, 27656,
+		28020, 28383, 28745, 29106, 29466, 29824, 30182, 30538,
+		30893, 31248, 31600, 31952, 32303, 32652, 33000, 33347,
+		33692, 34037, 34380, 34721, 35062, 35401, 35738, 36075,
+		36410, 36744, 37076, 37407, 37736, 38064, 38391, 38716,
+		39040, 39362, 39683, 40002, 40320, 40636, 40951, 41264,
+		41576, 41886, 42194, 42501, 42806, 43110, 43412, 43713,
+		44011, 44308, 44604, 44898, 45190, 45480, 45769, 46056,
+		46341, 46624, 46906, 47186, 47464, 47741, 48015, 48288,
+		48559, 48828, 49095, 49361, 49624, 49886, 50146, 50404,
+		50660, 50914, 51166, 51417, 51665, 51911, 52156, 52398,
+		52639, 52878, 53114, 53349, 53581, 53812, 54040, 54267,
+		54491, 54714, 54934, 55152, 55368, 55582, 55794, 56004,
+		56212, 56418, 56621, 56823, 57022, 57219, 57414, 57607,
+		57798, 57986, 58172, 58356, 58538, 58718, 58896, 59071,
+		59244, 59415, 59583, 59750, 59914, 60075, 60235, 60392,
+		60547, 60700, 60851, 60999, 61145, 61288, 61429, 61568,
+		61705, 61839, 61971, 62101, 62228, 62353, 62476, 62596,
+		62714, 62830, 62943, 63054, 63162, 63268, 63372, 63473,
+		63572, 63668, 63763, 63854, 63944, 64031, 64115, 64197,
+		64277, 64354, 64429, 64501, 64571, 64639, 64704, 64766,
+		64827, 64884, 64940, 64993, 65043, 65091, 65137, 65180,
+		65220, 65259, 65294, 65328, 65358, 65387, 65413, 65436,
+		65457, 65476, 65492, 65505, 65516, 65525, 65531, 65535,
+		65536
+	};
+
+	U32 quadrant = angle >> 30;
+	U32 pos = angle & (BAM_90 - 1);
+	U32 index;
+	U32 frac;
+	Q16 value;
+
+	//The second and fourth quarters are the first and third run backwards
+	if (quadrant & 1)
+	{
+		pos = BAM_90 - pos;
+	}
+
+	//Top 8 bits pick the table entry, the next 16 interpolate to the following one
+	index = pos >> 22;
+	frac = (pos >> 6) & 0xFFFF;
+
+	if (index >= 256)
+	{
+		value = QuarterSine[256];
+	}
+	else
+	{
+		value = QuarterSine[index] + (((QuarterSine[index + 1] - QuarterSine[index]) * (S32) frac) >> 16);
+	}
+
+	//The second half of the turn is negative
+	return (quadrant & 2) ? -value : value;
+}
+
+/** @brief   Cosine of a binary angle
+ *  @param   angle The angle, a full turn is 2^32
+ *  @return  The cosine as a Q16
+ */
+inline Q16 CosQ16(U32 angle)
+{
+	return SinQ16(angle + BAM_90);
+}
+
+/** @brief   Convert a binary angle to degrees
+ *  @param   angle The angle, a full turn is 2^32
+ *  @return  The angle in degrees, from -180 to 180, as a Q16
+ */
+inline Q16 Bam2DegQ16(U32 angle)
+{
+	return (Q16) (((S64) (S32) angle << Q16_SHIFT) / BAM_PER_DEGREE);
+}
+
+/** @brief   Convert degrees to a binary angle
+ *  @param   degrees The angle in degrees, as a Q16
+ *  @return  The angle, a full turn is 2^32
+ */
+inline U32 DegQ162Bam(Q16 degrees)
+{
+	return (U32) (((S64) degrees * BAM_PER_DEGREE) >> Q16_SHIFT);
+}
+
+
+#endif
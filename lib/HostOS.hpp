@@ -0,0 +1,154 @@
+//*************************************************************************************
+/** @file    HostOS.hpp
+ *  @brief   Stand-ins for the nxtOSEK services the lib/ files use, for a host build
+ *  @details When @c HOST_BUILD is defined the lib/ files include this instead of
+ * 			 the nxtOSEK kernel and NXtpandedLib headers, so that the comm code can be
+ * 			 compiled and run on a Linux PC. Only what lib/ actually uses is here:
+ * 			 \li The nxtOSEK integer types
+ * 			 \li @c SuspendAllInterrupts() / @c ResumeAllInterrupts(), which become one
+ * 				 process wide lock so tasks can be run as threads
+ * 			 \li @c NNxt::getTick() and @c NNxt::sleep(), with a tick that a replay
+ * 				 can set by hand
+ * 			 \li An @c ecrobot::Lcd that doesn't draw anything, and an enter button
+ * 				 that is never pressed
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *	  \li 10-18-2026 ARB The tick can be set by hand for replays
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _HOSTOS_H_
+#define _HOSTOS_H_
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdint.h>
+
+
+/**************************************************************************************
+ * nxtOSEK types
+ **************************************************************************************/
+typedef uint8_t  U8;
+typedef int8_t   S8;
+typedef uint16_t U16;
+typedef int16_t  S16;
+typedef uint32_t U32;
+typedef int32_t  S32;
+typedef unsigned long long U64;
+typedef signed long long   S64;
+
+
+/**************************************************************************************
+ * Critical sections
+ **************************************************************************************/
+/** @brief   The lock that stands in for disabling interrupts
+ *  @details It is recursive because a share may be read from inside another
+ * 			 critical section on the target without any harm.
+ */
+
+inline pthread_mutex_t* HostLock(void)
+{
+	static pthread_mutex_t lock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+	return &lock;
+}
+
+inline void SuspendAllInterrupts(void)
+{
+	pthread_mutex_lock(HostLock());
+}
+
+inline void ResumeAllInterrupts(void)
+{
+	pthread_mutex_unlock(HostLock());
+}
+
+
+/**************************************************************************************
+ * Timing
+ **************************************************************************************/
+
+namespace NNxt
+{
+	/** @brief   Tick to report instead of the real time, -1 for the real time
+	 *  @details A replay of logged data sets this to the time of each record,
+	 * 			 so the code under test sees the time stamps from the log.
+	 */
+	inline S64& HostSimTick(void)
+	{
+		static S64 tick = -1;
+		return tick;
+	}
+	
+	/** @brief   Time since some fixed point, in ms, like the NXT system tick
+	 */
+	inline U32 getTick(void)
+	{
+		struct timespec now;
+		
+		if (HostSimTick() >= 0)
+		{
+			return (U32) HostSimTick();
+		}
+		
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		return (U32) (now.tv_sec * 1000 + now.tv_nsec / 1000000);
+	}
+
+	/** @brief   Sleep the calling thread
+	 *  @param   ms Time to sleep, in ms
+	 */
+	inline void sleep(U32 ms)
+	{
+		usleep(ms * 1000);
+	}
+}
+
+
+/**************************************************************************************
+ * Display
+ **************************************************************************************/
+
+namespace ecrobot
+{
+	/** @brief   An LCD with nothing attached
+	 */
+	class Lcd
+	{
+	public:
+		void clear(bool update = false) {(void) update;}
+		void clearRow(U8 row, bool update = false) {(void) row; (void) update;}
+		void cursor(U8 x, U8 y) {(void) x; (void) y;}
+		void putf(const char* format, ...) {(void) format;}
+		void disp(void) {}
+	};
+}
+
+/** @brief   The enter button, which nobody can press on a PC
+ */
+
+inline U8 ecrobot_is_ENTER_button_pressed(void)
+{
+	return 0;
+}
+
+
+#endif
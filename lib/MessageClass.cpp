@@ -4,14 +4,13 @@
  *  @details The class allows for the creation of message objects
  * 			 and can package them to be sent via RS485 and decoded
  * 			 on the other end.
- * 			 <b>There are bugs with this code!</b> Be careful when
- * 			 using the encode and decode functions as they contain
- * 			 intermittent and troublesome bugs. However, for simple
- * 			 messages the @c SendMsgSimple and @c GetMsgSimple methods
- * 			 have been tested and found to be reliable.
+ * 			 The encode and decode functions stay inside the message
+ * 			 buffer whatever length is passed in or received, and
+ * 			 copy with @c memcpy rather than a byte at a time.
  *
  *  Revised:    
  *	  \li 03-09-2015 ARB Original file
+ *	  \li 10-18-2026 ARB Fixed the buffer handling in the encode and decode methods
  *
  *  License:
  *	 		
@@ -31,11 +30,20 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 //*************************************************************************************
 
+#ifdef HOST_BUILD
+#include <cstring>
+#else
 #include "../../yagarto-old/arm-none-eabi/include/c++/4.6.2/cstring"
+#endif
 
 #include "MessageClass.hpp"
 
+//On a PC the cable is simulated, see Rs485Sim.hpp
+#ifdef HOST_BUILD
+#include "Rs485Sim.hpp"
+#else
 #include <Rs485.h>
+#endif
 
 /*Create a RS485 object for communications 
  *Doesn't need port because port 4 is the only one that supports it
@@ -54,6 +62,8 @@ MessageClass::MessageClass(void)
 {
 	MsgData = new U8[MAX_MSG_LEN];
 	BufferSize = MAX_MSG_LEN;
+	MsgLen = 0;
+	SimpleID = idNoMsg;
 }
 
 /**************************************************************************************
@@ -61,14 +71,35 @@ MessageClass::MessageClass(void)
  **************************************************************************************/
 /** @brief   Class constructor
  *  @details If the length of the message is known, this will allocate
- * 			 that amount of memory. Note: it currently does not check to make
- * 			 sure the max is less than the arbiraty max value I chose to set.
+ * 			 that amount of memory. The length includes the header, so it is
+ * 			 made at least @c HEADER_LENGTH. Note: it currently does not check
+ * 			 to make sure the max is less than the arbiraty max value I chose to set.
  */
 
 MessageClass::MessageClass(U8 length)
 {
+	if (length < HEADER_LENGTH)
+	{
+		length = HEADER_LENGTH;
+	}
+	
 	MsgData = new U8[length];
 	BufferSize = length;
+	MsgLen = 0;
+	SimpleID = idNoMsg;
+}
+
+
+/**************************************************************************************
+ * MessageClass Destructor
+ **************************************************************************************/
+/** @brief   Class destructor
+ *  @details Frees the message buffer.
+ */
+
+MessageClass::~MessageClass(void)
+{
+	delete[] MsgData;
 }
 
 
@@ -77,14 +108,13 @@ MessageClass::MessageClass(U8 length)
  **************************************************************************************/
 /** @brief   Builds the message to be sent
  *  @details Gets info about the message and header. Then it creates the header
- * 	     attaches it to the message, and returns it. <b>The method might contain
- * 		 intermittent and difficult to find bugs! You have been warned </b>
+ * 	     and puts it in the buffer, followed by the data.
  * 
  *  @param   data  A pointer to the data to send.
  *  @param   dType The type of data, specificed by the @c comHeaderDatatype enum
  *  @param   dID   The data identifier, specificed by the @c commHeaderDataID enum
- *  @param   len   The length of the data to be sent. Anything longer than
- * 			       MAX_MSG_LEN - HEADER_LENGTH will be truncated.
+ *  @param   len   The length of the data to be sent. Anything longer than the
+ * 			       buffer size less @c HEADER_LENGTH will be truncated.
  * 
  *  @return  Length of data and header
  *  
@@ -92,34 +122,27 @@ MessageClass::MessageClass(U8 length)
 
 U8 MessageClass::BuildMsg( U8* data2send, comDatatype dType, comDataID dID, U8 len)
 {
-   
-	MsgLen = len;
+	HeaderData header;
 	
-	//Build header data
-    mHeaderData.datatype = dType;
-    mHeaderData.length = len;
-    mHeaderData.dataID = dID;
+	//Only send what fits
+	if (len > BufferSize - HEADER_LENGTH)
+	{
+		len = BufferSize - HEADER_LENGTH;
+	}
 	
 	//Build header
-	mHeader.HD = mHeaderData;
-    
-	//Clear old memory
-	memset(MsgData, 0 , BufferSize);
+	header.datatype = dType;
+	header.length = len;
+	header.dataID = dID;
 	
-	//Put header at start of packet
-	for (U8 n=0; n<HEADER_LENGTH; n++)
-	{
-		MsgData[n] = mHeader.asbyte[n];
-	}
+	//Header at the start of the packet, data right after it
+	memcpy(MsgData, &header, HEADER_LENGTH);
+	memcpy(&MsgData[HEADER_LENGTH], data2send, len);
 	
-	//Add the data to the packet
-	for (U8 i=0; i<len; i++)
-	{
-		MsgData[(HEADER_LENGTH+i)] = data2send[i];
-	}
-    
-    //Return length of data and header
-    return len + HEADER_LENGTH;
+	MsgLen = len + HEADER_LENGTH;
+	
+	//Return length of data and header
+	return MsgLen;
 }
 
 
@@ -130,47 +153,46 @@ U8 MessageClass::BuildMsg( U8* data2send, comDatatype dType, comDataID dID, U8 l
  **************************************************************************************/
 /** @brief   Decodes the received message currently in MsgData
  *  @details Gets the information stored in the message header and passes
- * 		     it back to the calling function by reference. Then it clears the
- * 			 @c MsgData array and fills it with the received data. Make sure to
- *			 delete what is pointed to by @c data after you use it if space is an issue.
- *			 <b>The method might contain intermittent and difficult to find bugs! You have been warned </b>
+ * 		     it back to the calling function by reference. The header is checked
+ * 			 against the number of bytes that were actually received, and a
+ * 			 message which is too short for its header is refused.
  * 
- * @param    data Pointer to the start of the received message data
  * @param    dType The type of data received
  * @param    dID   The ID number of the data received
- * @param    len   The length of the message received
+ * @param    len   The length of the message received, 0 if it was refused
  * 
- * @return   Pointer to the message data
+ * @return   Pointer to the message data inside this object, valid until the
+ * 			 next message is built or received. NULL if the message was refused.
  */
 
 U8* MessageClass::DecodeMsg(comDatatype& dType, comDataID& dID, U8& len)
 {
-    
-	//Get header info
-	for (U8 n=0; n<HEADER_LENGTH; n++)
-	{
-		mHeader.asbyte[n] = MsgData[n];
-	}
-	
-	mHeaderData = mHeader.HD;
+	HeaderData header;
 	
-	//Decode header	
-	dType = static_cast<comDatatype> (mHeaderData.datatype);
-	dID =   static_cast<comDataID> (mHeaderData.dataID);
-	len = mHeaderData.length;
+	dType = typeUnspec;
+	dID = idNoMsg;
+	len = 0;
 	
-	MsgLen = len;
+	//Need a whole header
+	if (MsgLen < HEADER_LENGTH)
+	{
+		return NULL;
+	}
 	
-	U8* p_data2get = new U8[len];
+	memcpy(&header, MsgData, HEADER_LENGTH);
 	
-	//Add the data to the packet
-	for (U8 i=0; i<len; i++)
+	//Don't trust a header which claims more data than arrived
+	if (header.length > MsgLen - HEADER_LENGTH)
 	{
-		p_data2get[i] = MsgData[(HEADER_LENGTH+i)];
-	}	
+		return NULL;
+	}
 	
-	return p_data2get;
+	//Decode header	
+	dType = static_cast<comDatatype> (header.datatype);
+	dID =   static_cast<comDataID> (header.dataID);
+	len = header.length;
 	
+	return &MsgData[HEADER_LENGTH];
 }
 
 
@@ -180,12 +202,16 @@ U8* MessageClass::DecodeMsg(comDatatype& dType, comDataID& dID, U8& len)
  **************************************************************************************/
 /** @brief  Receive a message from the comm port
  *  @details Use this with the decode message funciton to decode
- * 			 the header and data packaged in the message
+ * 			 the header and data packaged in the message. Reads as much as
+ * 			 the buffer holds.
+ *  @return  Number of bytes received, header included
  */
  
  U32 MessageClass::GetMsg(void)
  {
-	return  MsgComm.receive(MsgData, 0, MsgLen);
+	MsgLen = (U8) MsgComm.receive(MsgData, 0, BufferSize);
+	
+	return MsgLen;
  }
  
  
@@ -201,7 +227,7 @@ U8* MessageClass::DecodeMsg(comDatatype& dType, comDataID& dID, U8& len)
  
  U32 MessageClass::SendMsg(void)
  {
-	return  MsgComm.send(MsgData, 0, MsgLen+HEADER_LENGTH);
+	return  MsgComm.send(MsgData, 0, MsgLen);
  }
  
  
@@ -215,15 +241,7 @@ U8* MessageClass::DecodeMsg(comDatatype& dType, comDataID& dID, U8& len)
  
 bool MessageClass::isEmpty(void)
  {
-	
-	bool empty = true;
-	
-	if (MsgLen > 0)
-	{
-		empty = false;
-	}
-	 
-	return  empty;
+	return (MsgLen == 0);
  }
  
  
@@ -236,7 +254,7 @@ bool MessageClass::isEmpty(void)
  
 void MessageClass::clearData(void)
  {
-	memset(MsgData, 0, MAX_MSG_LEN);
+	memset(MsgData, 0, BufferSize);
 	MsgLen = 0;
  }
  
@@ -5,6 +5,7 @@
  *
  *  Revised:    
  *	  \li 03-09-2015 ARB Original file
+ *	  \li 10-18-2026 ARB Fixed the buffer handling in the encode and decode methods
  *
  *  License:
  *	 		
@@ -28,6 +29,11 @@
 #ifndef _MSGHEADER_H_
 #define _MSGHEADER_H_
 
+//On a PC the nxtOSEK types come from the host stand-ins
+#ifdef HOST_BUILD
+#include "HostOS.hpp"
+#endif
+
 /**************************************************************************************
  * Message class
  **************************************************************************************/
@@ -35,10 +41,10 @@
  *  @details  An instance of this message object can be used to hold message
  * 			 data and automatically build a header to send in front of data
  * 			 so that the receiver knows what to do with it.
- * 			<b> This class still has some bugs!</b> The encoding and decoding 
- * 			 methods need some work still, but one should be able to get away 
- * 			 for the most part with clever use of the @c SendMsgSimple and 
- * 			 @c GetMsgSimple methods.
+ * 			 The buffer holds the header followed by the data, and every method
+ * 			 keeps within it: data too long for the buffer is truncated when it is
+ * 			 built, and a received header which claims more data than arrived is
+ * 			 refused when it is decoded. No memory is allocated after construction.
  */
 
  
@@ -62,8 +68,9 @@ public:
 		typeBool = 	 3, /**<Boolean type*/
 		typeFloat =	 4, /**<32bit floating-point number*/
 		typeU8 = 	 5, /**<8bit signed char*/
-		typeString = 6  /**<C-String type*/
-		// free 7 - 255
+		typeString = 6, /**<C-String type*/
+		typeRaw = 	 7  /**<Raw bytes of a struct both bricks share, like CommEngine::LinkStats*/
+		// free 8 - 255
 	};
 
 	
@@ -76,20 +83,28 @@ public:
 		idWakeMsg = 1, /**<Let the other brick know the sender is alive!*/
 		idAckMsg   = 2, /**<General acknowlegement of received message*/
 		idInitDone = 3,  /**<Initialization has been completed*/
+		idFrameStart = 4, /**<Reserved: marks the start of a framed message (see @c CommEngine)*/
+		idFrameEscape = 5, /**<Reserved: escapes reserved bytes inside a framed message*/
+		idPing = 6,        /**<Link test, answered with idPong right away*/
+		idPong = 7,        /**<Answer to idPing*/
+		idStatsRequest = 8, /**<Ask the other brick for its link counters*/
+		idStatsReport = 9,  /**<Frame holding the sender's link counters*/
 		
 		//Stuff Master needs to tell slave
 		idPrepForGrabRings = 10,
 		idGrabRings = 11,
 		idPrepForPlacement = 12,
 		idPlaceRings = 13,
+		idParamTable = 14, /**<Frame holding the slave tuning table (see @c ParamTable)*/
 		
 		//Stuff Slave needs to tell master
 		idReadytoGrab = 50,
 		idGrabbedRings = 51,
 		idReadytoPlace = 52,
-		idPlacedRings = 53
+		idPlacedRings = 53,
+		idParamAck = 54     /**<Frame holding the checksum of the slave's tuning table*/
 		
-		//Free values: 4-9, 14-49, 54-255
+		//Free values: 15-49, 55-255
 	};
 	
 	//Default Constructor
@@ -98,6 +113,9 @@ public:
 	//Constructor used when message length is known
 	MessageClass(U8 length);
 	
+	//Destructor
+	~MessageClass(void);
+	
 	//decodes message that was received
 	U8* DecodeMsg(comDatatype& dType, comDataID& dID, U8& len);
 	
@@ -133,27 +151,18 @@ public:
 	
 protected:
 
-	//Message header data
+	//Message header, which is put in front of the data in each message
 	struct HeaderData
 	{
 		U8 datatype;   /**<Type of data the message contains*/
 		U8 length;     /**<Length of the data in the message*/
 		U8 dataID;     /**<Extra info so the recieve know what the data is*/
-	} mHeaderData;
-
-
-	/*This is a header that will be stuck on each set of data that is put in front of each message*/
-	union  RS485_Header
-	{
-		HeaderData HD;
-		U8 asbyte[sizeof(HD)];
-		
-	} mHeader;
+	};
 	
 	//Pointer to all the message data stored in this object
 	U8* MsgData;
 	
-	//Length of the current message
+	//Number of bytes in MsgData, header included
 	U8  MsgLen;	
 	
 	//Max size of the message buffer
@@ -162,6 +171,11 @@ protected:
 	//Storage for ID returned from simple message get function
 	comDataID SimpleID;
 	
+private:
+
+	//The buffer belongs to one object, so messages can't be copied
+	MessageClass(const MessageClass&);
+	MessageClass& operator=(const MessageClass&);
 	
 };
 
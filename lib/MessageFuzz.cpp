@@ -0,0 +1,751 @@
+//*************************************************************************************
+/** @file    MessageFuzz.cpp
+ *  @brief   Checks MessageClass's and CommEngine's encode and decode on a PC, and
+ * 			 times them
+ *  @details This is not part of either brick's build. It runs the real
+ * 			 @c MessageClass and @c CommEngine in five parts:
+ * 			 \li Round trip: random messages of every length, in buffers of every
+ * 				 size, must decode to what was built. Data too long for the buffer
+ * 				 must come back truncated to what fits.
+ * 			 \li Link: the same, sent with @c SendMsg() and received with
+ * 				 @c GetMsg() over the simulated cable in Rs485Sim.hpp.
+ * 			 \li Fuzz: random bytes, cut short messages, and headers claiming
+ * 				 lengths up to 255 are decoded. A message must be refused exactly
+ * 				 when its header claims more data than arrived, and what is
+ * 				 returned must lie inside the bytes that arrived.
+ * 			 \li Entry: @c LLVMFuzzerTestOneInput() is given random bytes and
+ * 				 real frames with bytes changed or cut off. It decodes the bytes
+ * 				 as a message and feeds them one at a time to
+ * 				 @c CommEngine::RxByte(), and checks every frame handed on fits
+ * 				 in a frame and came with a good CRC.
+ * 			 \li Benchmark: a message built, framed, run back through
+ * 				 @c RxByte() and read by the frame handler, at a few lengths.
+ *
+ * 			 The buffer is allocated to the exact size asked for, so building
+ * 			 with @c -fsanitize=address catches any read or write outside it.
+ * 			 It prints each failure it finds and exits with 1 if there were any.
+ *
+ * 			 Build and run with:
+ * 			 @code
+ * 			 g++ -O1 -g -DHOST_BUILD -fsanitize=address,undefined MessageFuzz.cpp -o MessageFuzz -lpthread
+ * 			 ./MessageFuzz [iterations [seed]]
+ * 			 @endcode
+ * 			 Build with @c -O2 and no sanitizers for benchmark numbers.
+ *
+ * 			 The entry point also works with libFuzzer, which then takes the
+ * 			 place of @c main():
+ * 			 @code
+ * 			 clang++ -O1 -g -DHOST_BUILD -DLIBFUZZER -fsanitize=fuzzer,address,undefined MessageFuzz.cpp -o MessageFuzz -lpthread
+ * 			 ./MessageFuzz
+ * 			 @endcode
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *	  \li 10-18-2026 ARB Fuzz entry point which also feeds CommEngine, benchmark
+ * 			 runs a message end to end
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+#ifndef HOST_BUILD
+#error MessageFuzz.cpp only builds on a PC, with -DHOST_BUILD
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "CommEngine.hpp"
+
+
+/**************************************************************************************
+ * Constants
+ **************************************************************************************/
+
+//Random cases in each of the checks, unless given on the command line
+#define DEFAULT_ITERATIONS 200000
+
+//Messages sent over the simulated cable
+#define LINK_MESSAGES 2000
+
+//Messages timed end to end at each length
+#define BENCH_COUNT 1000000
+
+//Failures printed before the rest are only counted
+#define MAX_PRINTED 20
+
+//Report a broken check with the case it broke on
+#define CHECK(cond, what) do { if (!(cond)) {fail(what, __LINE__);} } while (0)
+
+//The engine draws its statistics page on the screen
+ecrobot::Lcd Display;
+
+
+/**************************************************************************************
+ * Probe
+ **************************************************************************************/
+/** @brief   A message whose buffer can be filled with any bytes
+ *  @details Stands in for @c GetMsg() receiving them, without the cable, so the
+ * 			 decoder can be fed millions of hostile messages quickly.
+ */
+
+class MessageProbe : public MessageClass
+{
+
+public:
+
+	MessageProbe(U8 length) : MessageClass(length) {}
+
+	//Put bytes in the buffer as if they had been received, as many as fit
+	void Receive(const U8* bytes, U8 count)
+	{
+		if (count > BufferSize) {count = BufferSize;}
+
+		memcpy(MsgData, bytes, count);
+		MsgLen = count;
+	}
+
+	//Cut the message short, as if the end never arrived
+	void Truncate(U8 count)
+	{
+		if (count < MsgLen) {MsgLen = count;}
+	}
+
+	U8* Buffer(void) {return MsgData;}
+	U8 Length(void) {return MsgLen;}
+	U8 Size(void) {return BufferSize;}
+
+};
+
+/** @brief   A comm engine whose receive side can be fed bytes directly
+ *  @details Stands in for @c Poll() reading them off the cable.
+ */
+
+class EngineProbe : public CommEngine
+{
+
+public:
+
+	EngineProbe(void) : CommEngine(roleSlave, &TxQueue, &RxID, &RxReady) {}
+
+	void Receive(U8 byte) {RxByte(byte);}
+
+	//A frame as it would go out on the wire
+	static U8 Frame(U8* p_frame, const U8* data, MessageClass::comDatatype dType, MessageClass::comDataID dID, U8 len)
+	{
+		return BuildFrame(p_frame, data, dType, dID, len);
+	}
+
+protected:
+
+	TaskQueue<CommTxMsg> TxQueue;
+	TaskShare<U8> RxID;
+	TaskShare<bool> RxReady;
+
+};
+
+
+/**************************************************************************************
+ * Helpers
+ **************************************************************************************/
+
+U32 Failures = 0;
+U32 Seed = 1;
+
+/** @brief   Count a failure, and print the first few
+ */
+
+void fail(const char* what, int line)
+{
+	if (Failures++ < MAX_PRINTED)
+	{
+		printf("  FAIL line %d: %s\n", line, what);
+	}
+
+#ifdef LIBFUZZER
+	//libFuzzer saves the input that made it stop
+	abort();
+#endif
+}
+
+/** @brief   Random 32 bit number (xorshift), the same every run for a seed
+ */
+
+U32 random32(void)
+{
+	Seed ^= Seed << 13;
+	Seed ^= Seed >> 17;
+	Seed ^= Seed << 5;
+	return Seed;
+}
+
+/** @brief   Random byte
+ */
+
+U8 random8(void)
+{
+	return (U8) (random32() >> 24);
+}
+
+/** @brief   Fill a buffer with random bytes
+ */
+
+void randomFill(U8* data, U32 count)
+{
+	for (U32 i = 0; i < count; i++)
+	{
+		data[i] = random8();
+	}
+}
+
+/** @brief   A buffer size to test, weighted towards the sizes the bricks use
+ */
+
+U8 randomSize(void)
+{
+	switch (random32() % 4)
+	{
+		case 0:  return MessageClass::MAX_MSG_LEN;
+		case 1:  return (U8) (random32() % (MessageClass::HEADER_LENGTH + 1));
+		default: return random8();
+	}
+}
+
+/** @brief   Random data type and ID
+ *  @details Kept inside the range each enum can hold, which is all the values
+ * 			 that fit in the bits its largest member needs.
+ */
+
+MessageClass::comDatatype randomType(void)
+{
+	return (MessageClass::comDatatype) (random8() % 8);
+}
+
+MessageClass::comDataID randomID(void)
+{
+	return (MessageClass::comDataID) (random8() % 64);
+}
+
+/** @brief   Time in ns
+ */
+
+double nowNs(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+
+/**************************************************************************************
+ * Round trip
+ **************************************************************************************/
+/** @brief   Build a message and check it decodes to what went in
+ *  @details The data is in its own allocation of exactly @c len bytes, so the
+ * 			 sanitizer catches @c BuildMsg() reading past it.
+ *  @return  The length the data should have been truncated to
+ */
+
+U8 roundTrip(MessageProbe& msg, MessageClass::comDatatype dType, MessageClass::comDataID dID, U8 len)
+{
+	U8* data = new U8[len > 0 ? len : 1];
+	U8 fits = (len > msg.Size() - MessageClass::HEADER_LENGTH) ? (U8) (msg.Size() - MessageClass::HEADER_LENGTH) : len;
+	MessageClass::comDatatype gotType;
+	MessageClass::comDataID gotID;
+	U8 gotLen;
+	U8* got;
+
+	randomFill(data, len);
+
+	CHECK(msg.BuildMsg(data, dType, dID, len) == fits + MessageClass::HEADER_LENGTH, "BuildMsg returned the wrong length");
+
+	got = msg.DecodeMsg(gotType, gotID, gotLen);
+
+	CHECK(got != NULL, "a message that was just built was refused");
+
+	if (got != NULL)
+	{
+		CHECK(gotType == dType, "data type changed");
+		CHECK(gotID == dID, "data ID changed");
+		CHECK(gotLen == fits, "length wasn't truncated to what fits");
+		CHECK(got == msg.Buffer() + MessageClass::HEADER_LENGTH, "data doesn't follow the header");
+		CHECK(memcmp(got, data, gotLen) == 0, "data changed");
+	}
+
+	delete[] data;
+
+	return fits;
+}
+
+/** @brief   Random messages in buffers of random sizes
+ */
+
+void checkRoundTrip(U32 iterations)
+{
+	for (U32 n = 0; n < iterations; n++)
+	{
+		MessageProbe msg(randomSize());
+
+		roundTrip(msg, randomType(), randomID(), random8());
+	}
+
+	//Every length in the buffer the bricks use, the edges included
+	for (U32 len = 0; len <= 255; len++)
+	{
+		MessageProbe msg(MessageClass::MAX_MSG_LEN);
+
+		roundTrip(msg, MessageClass::typeRaw, MessageClass::idParamTable, (U8) len);
+	}
+}
+
+
+/**************************************************************************************
+ * Link
+ **************************************************************************************/
+/** @brief   Make the simulated cable the first time it is needed
+ *  @details A clean cable with no baud rate, so each message is there to be
+ * 			 received as soon as it is sent. Both ends are played by this thread.
+ *  @return  False if the cable could not be made
+ */
+
+bool openLink(void)
+{
+	static bool open = false;
+	ecrobot::Rs485::LinkConfig clean = {0, 0, 0, 0};
+
+	if (!open)
+	{
+		ecrobot::Rs485::Configure(clean);
+		open = ecrobot::Rs485::CreateLink();
+	}
+
+	return open;
+}
+
+/** @brief   Throw away what has arrived at one end, so the cable never fills up
+ */
+
+void drainLink(ecrobot::Rs485::linkEnd end)
+{
+	U8 chunk[64];
+
+	ecrobot::Rs485::Attach(end);
+	while (MsgComm.receive(chunk, 0, sizeof(chunk)) > 0) {}
+}
+
+/** @brief   Send messages over the simulated cable and decode them at the far end
+ */
+
+void checkLink(void)
+{
+	MessageClass tx;
+	MessageClass rx;
+	U8 data[MessageClass::MAX_MSG_LEN];
+
+	if (!openLink())
+	{
+		fail("could not make the link", __LINE__);
+		return;
+	}
+
+	for (U32 n = 0; n < LINK_MESSAGES; n++)
+	{
+		U8 len = (U8) (random32() % (MessageClass::MAX_MSG_LEN - MessageClass::HEADER_LENGTH + 1));
+		MessageClass::comDatatype dType = randomType();
+		MessageClass::comDataID dID = randomID();
+		MessageClass::comDatatype gotType;
+		MessageClass::comDataID gotID;
+		U8 gotLen;
+		U8* got;
+
+		randomFill(data, len);
+
+		ecrobot::Rs485::Attach(ecrobot::Rs485::END_MASTER);
+		tx.BuildMsg(data, dType, dID, len);
+		CHECK(tx.SendMsg() == (U32) len + MessageClass::HEADER_LENGTH, "SendMsg didn't send the whole message");
+
+		ecrobot::Rs485::Attach(ecrobot::Rs485::END_SLAVE);
+		CHECK(rx.GetMsg() == (U32) len + MessageClass::HEADER_LENGTH, "GetMsg didn't get the whole message");
+
+		got = rx.DecodeMsg(gotType, gotID, gotLen);
+
+		CHECK(got != NULL && gotType == dType && gotID == dID && gotLen == len && memcmp(got, data, len) == 0,
+			  "message changed on the way over the link");
+	}
+}
+
+
+/**************************************************************************************
+ * Fuzz
+ **************************************************************************************/
+/** @brief   Decode whatever is in the message and check the answer is safe
+ *  @details The decoder must refuse a message exactly when it is shorter than a
+ * 			 header or its header claims more data than arrived, and otherwise
+ * 			 return data that lies inside the bytes that arrived.
+ */
+
+void decodeAny(MessageProbe& msg)
+{
+	MessageClass::comDatatype dType;
+	MessageClass::comDataID dID;
+	U8 len = 0xAA;
+	U8* got = msg.DecodeMsg(dType, dID, len);
+	U8 arrived = msg.Length();
+	bool valid = (arrived >= MessageClass::HEADER_LENGTH &&
+				  msg.Buffer()[1] <= arrived - MessageClass::HEADER_LENGTH);
+
+	if (!valid)
+	{
+		CHECK(got == NULL, "accepted a message shorter than its header says");
+		CHECK(len == 0 && dType == MessageClass::typeUnspec && dID == MessageClass::idNoMsg,
+			  "a refused message didn't clear the outputs");
+		return;
+	}
+
+	CHECK(got != NULL, "refused a message that was all there");
+
+	if (got != NULL)
+	{
+		CHECK(got >= msg.Buffer() + MessageClass::HEADER_LENGTH && got + len <= msg.Buffer() + arrived,
+			  "data returned outside what arrived");
+
+		//Read it all, so the sanitizer sees it if the check above is wrong
+		U8 sum = 0;
+		for (U8 i = 0; i < len; i++) {sum += got[i];}
+		(void) sum;
+	}
+}
+
+/** @brief   Random bytes, cut short messages and hostile lengths
+ */
+
+void checkFuzz(U32 iterations)
+{
+	U8 bytes[256];
+
+	for (U32 n = 0; n < iterations; n++)
+	{
+		MessageProbe msg(randomSize());
+		U8 count = random8();
+
+		switch (n % 4)
+		{
+			//Noise
+			case 0:
+				randomFill(bytes, count);
+				msg.Receive(bytes, count);
+				break;
+
+			//A good message with its end lost
+			case 1:
+				roundTrip(msg, randomType(), randomID(), random8());
+				msg.Truncate(random8() % (msg.Length() + 1));
+				break;
+
+			//A header claiming a bit more than arrived
+			case 2:
+				randomFill(bytes, count);
+				if (count >= MessageClass::HEADER_LENGTH)
+				{
+					bytes[1] = (U8) (count - MessageClass::HEADER_LENGTH + 1 + random32() % 4);
+				}
+				msg.Receive(bytes, count);
+				break;
+
+			//A header claiming as much as a byte can say
+			default:
+				randomFill(bytes, count);
+				bytes[1] = 0xFF;
+				msg.Receive(bytes, count);
+				break;
+		}
+
+		decodeAny(msg);
+	}
+
+	//Every header length against every number of bytes arrived, in the bricks' buffer
+	for (U32 arrived = 0; arrived <= MessageClass::MAX_MSG_LEN; arrived++)
+	{
+		for (U32 claim = 0; claim <= 255; claim++)
+		{
+			MessageProbe msg(MessageClass::MAX_MSG_LEN);
+
+			randomFill(bytes, MessageClass::MAX_MSG_LEN);
+			bytes[1] = (U8) claim;
+			msg.Receive(bytes, (U8) arrived);
+
+			decodeAny(msg);
+		}
+	}
+
+	//A cleared message has nothing to decode
+	MessageProbe msg(MessageClass::MAX_MSG_LEN);
+	msg.clearData();
+	decodeAny(msg);
+}
+
+
+/**************************************************************************************
+ * Entry
+ **************************************************************************************/
+
+//What the frame handler has been given since the count was cleared
+U32 FramesHandled = 0;
+U32 FrameSum = 0;
+
+/** @brief   Frame handler which checks and reads each frame it is given
+ */
+
+void onFrame(MessageClass::comDatatype dType, MessageClass::comDataID dID, U8* data, U8 len)
+{
+	(void) dType;
+	(void) dID;
+
+	CHECK(len <= CommEngine::MAX_FRAME_DATA, "handed on more data than a frame holds");
+
+	//Read it all, so the sanitizer sees it if the data isn't all in the frame
+	for (U8 i = 0; i < len; i++) {FrameSum += data[i];}
+
+	FramesHandled++;
+}
+
+/** @brief   Decode any bytes as a message, and run them through the engine's framing
+ *  @details The bytes are decoded with @c decodeAny(), then given to a new engine
+ * 			 one at a time as if they came off the cable. A frame may only be
+ * 			 handed on if its CRC was good. Whatever the engine sends back, such
+ * 			 as answers to pings, is thrown away.
+ *  @param   data Bytes to decode
+ *  @param   size Number of bytes
+ *  @return  0, as libFuzzer wants
+ */
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	MessageProbe msg(MessageClass::MAX_MSG_LEN);
+	EngineProbe engine;
+
+	msg.Receive(data, (size > 255) ? 255 : (U8) size);
+	decodeAny(msg);
+
+	if (!openLink())
+	{
+		return 0;
+	}
+
+	engine.setFrameHandler(onFrame);
+	FramesHandled = 0;
+	FrameSum = 0;
+
+	ecrobot::Rs485::Attach(ecrobot::Rs485::END_SLAVE);
+
+	for (size_t i = 0; i < size; i++)
+	{
+		engine.Receive(data[i]);
+	}
+
+	CHECK(FramesHandled <= engine.GetStats().framesRecv, "handed on a frame with a bad CRC");
+
+	drainLink(ecrobot::Rs485::END_MASTER);
+
+	return 0;
+}
+
+/** @brief   Real frames back to back, as they would come off the cable
+ *  @param   bytes Where to put them, at least 4 * @c MAX_FRAME_BYTES long
+ *  @param   sum   Set to the sum of all the data in them
+ *  @return  Number of bytes of frames
+ */
+
+U32 randomFrames(U8* bytes, U32& sum)
+{
+	U8 data[CommEngine::MAX_FRAME_DATA];
+	U32 count = 0;
+
+	sum = 0;
+
+	for (U8 n = 0; n < 4; n++)
+	{
+		U8 len = (U8) (random32() % (CommEngine::MAX_FRAME_DATA + 1));
+		MessageClass::comDataID dID = randomID();
+
+		//Stats reports are kept by the engine rather than handed on
+		if (dID == MessageClass::idStatsReport) {dID = MessageClass::idParamTable;}
+
+		randomFill(data, len);
+		for (U8 i = 0; i < len; i++) {sum += data[i];}
+
+		count += EngineProbe::Frame(&bytes[count], data, randomType(), dID, len);
+	}
+
+	return count;
+}
+
+/** @brief   Random bytes, and real frames whole, changed and cut short, through
+ * 			 the fuzz entry point
+ */
+
+void checkEntry(U32 iterations)
+{
+	U8 bytes[4 * CommEngine::MAX_FRAME_BYTES];
+	U32 count;
+	U32 sum;
+
+	for (U32 n = 0; n < iterations; n++)
+	{
+		switch (n % 4)
+		{
+			//Noise
+			case 0:
+				count = random8();
+				randomFill(bytes, count);
+				break;
+
+			//Frames which must all be handed on as they were sent
+			case 1:
+				count = randomFrames(bytes, sum);
+				LLVMFuzzerTestOneInput(bytes, count);
+				CHECK(FramesHandled == 4 && FrameSum == sum, "frames changed on the way through the engine");
+				continue;
+
+			//Frames with a byte changed
+			case 2:
+				count = randomFrames(bytes, sum);
+				bytes[random32() % count] = random8();
+				break;
+
+			//Frames cut off part way
+			default:
+				count = randomFrames(bytes, sum);
+				count = random32() % count;
+				break;
+		}
+
+		LLVMFuzzerTestOneInput(bytes, count);
+	}
+}
+
+
+/**************************************************************************************
+ * Benchmark
+ **************************************************************************************/
+
+//Where the benchmark's frame handler decodes the message, and what it read
+MessageProbe* BenchRx = NULL;
+U32 BenchSum = 0;
+
+/** @brief   Frame handler which decodes the message in the frame and reads its data
+ */
+
+void onBenchFrame(MessageClass::comDatatype dType, MessageClass::comDataID dID, U8* data, U8 len)
+{
+	U8 gotLen;
+	U8* got;
+
+	BenchRx -> Receive(data, len);
+	got = BenchRx -> DecodeMsg(dType, dID, gotLen);
+
+	if (got != NULL)
+	{
+		for (U8 i = 0; i < gotLen; i++) {BenchSum += got[i];}
+	}
+}
+
+/** @brief   Time one message end to end, over and over
+ *  @details The message is built, put in a frame, given to the engine a byte at
+ * 			 a time, and decoded and read by the frame handler. Only the cable is
+ * 			 left out, as the simulated one would time the PC's sockets.
+ *  @param   len Data bytes in the message, at most @c MAX_FRAME_DATA less a header
+ */
+
+void benchmark(U8 len)
+{
+	MessageProbe tx((U8) (len + MessageClass::HEADER_LENGTH));
+	MessageProbe rx((U8) (len + MessageClass::HEADER_LENGTH));
+	EngineProbe engine;
+	U8 data[CommEngine::MAX_FRAME_DATA];
+	U8 frame[CommEngine::MAX_FRAME_BYTES];
+	U8 frameLen;
+	U32 sum = 0;
+	double start;
+	double ns;
+
+	BenchRx = &rx;
+	BenchSum = 0;
+	engine.setFrameHandler(onBenchFrame);
+
+	randomFill(data, len);
+
+	start = nowNs();
+	for (U32 n = 0; n < BENCH_COUNT; n++)
+	{
+		data[0] = (U8) n;
+		sum += (U8) n;
+
+		tx.BuildMsg(data, MessageClass::typeRaw, MessageClass::idParamTable, len);
+		frameLen = EngineProbe::Frame(frame, tx.Buffer(), MessageClass::typeRaw, MessageClass::idParamTable, tx.Length());
+
+		for (U8 i = 0; i < frameLen; i++)
+		{
+			engine.Receive(frame[i]);
+		}
+	}
+	ns = (nowNs() - start) / BENCH_COUNT;
+
+	for (U8 i = 1; i < len; i++) {sum += data[i] * BENCH_COUNT;}
+
+	CHECK(engine.GetStats().framesRecv == BENCH_COUNT && BenchSum == sum, "benchmark messages changed on the way");
+
+	printf("  %3u data bytes: %6.1f ns each (%6.1f MB/s of data)\n", len, ns, len / ns * 1000);
+}
+
+
+/**************************************************************************************
+ * Main
+ **************************************************************************************/
+
+#ifndef LIBFUZZER
+
+int main(int argc, char** argv)
+{
+	U32 iterations = (argc > 1) ? (U32) atoi(argv[1]) : DEFAULT_ITERATIONS;
+
+	Seed = (argc > 2) ? (U32) atoi(argv[2]) : 1;
+	if (Seed == 0) {Seed = 1;}
+
+	printf("round trip, %u random messages\n", iterations);
+	checkRoundTrip(iterations);
+
+	printf("link, %u messages over the simulated cable\n", LINK_MESSAGES);
+	checkLink();
+
+	printf("fuzz, %u random inputs and every length against every header\n", iterations);
+	checkFuzz(iterations);
+
+	printf("entry, %u random inputs and frames through the fuzz entry point\n", iterations);
+	checkEntry(iterations);
+
+	printf("%u failures\n\n", Failures);
+
+	printf("benchmark, %u messages built, framed and decoded at each length\n", BENCH_COUNT);
+	benchmark(MessageClass::MAX_MSG_LEN - MessageClass::HEADER_LENGTH);
+	benchmark(24);
+	benchmark(CommEngine::MAX_FRAME_DATA - MessageClass::HEADER_LENGTH);
+
+	return (Failures == 0) ? 0 : 1;
+}
+
+#endif
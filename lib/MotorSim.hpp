@@ -0,0 +1,97 @@
+//*************************************************************************************
+/** @file    MotorSim.hpp
+ *  @brief   A simulated NXT motor for running the odometry code on a PC
+ *  @details When @c HOST_BUILD is defined, @c RobotClass uses this in place of the
+ * 			 ecrobot @c Motor class. There is no motor model: whatever drives the
+ * 			 simulation sets the encoder count with @c setCount(), and the last
+ * 			 power asked for can be read back with @c getPWM().
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *	  \li 10-18-2026 ARB Added setBrake()
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _MOTORSIM_H_
+#define _MOTORSIM_H_
+
+#include "HostOS.hpp"
+
+//Stands in for the ecrobot motor port type
+typedef U8 ePortM;
+
+namespace ecrobot
+{
+
+/**************************************************************************************
+ * Simulated Motor class
+ **************************************************************************************/
+/** @brief  Drop-in replacement for @c ecrobot::Motor on a PC.
+ *  @details The count is volatile because a replay may set it from one thread
+ * 			 while the code under test reads it from another, like the real
+ * 			 encoder being counted by an interrupt.
+ */
+
+class Motor
+{
+
+public:
+
+	//Constructor
+	Motor(ePortM port = 0, bool brake = true)
+	{
+		(void) port;
+		this -> brake = brake;
+		count = 0;
+		pwm = 0;
+	}
+
+	//Encoder count, in degrees of shaft rotation
+	S32 getCount(void) const {return count;}
+
+	//Set the encoder count, as the simulation moves the wheel
+	void setCount(S32 newCount) {count = newCount;}
+
+	//Power asked for, -100 to 100
+	void setPWM(S8 newPWM) {pwm = newPWM;}
+	S8 getPWM(void) const {return pwm;}
+
+	//Brake or float at zero power, only remembered
+	void setBrake(bool newBrake) {brake = newBrake;}
+	bool getBrake(void) const {return brake;}
+
+	//Zero the encoder and stop
+	void reset(void)
+	{
+		count = 0;
+		pwm = 0;
+	}
+
+protected:
+
+	volatile S32 count;
+	S8 pwm;
+	bool brake;
+
+};
+
+}
+
+#endif
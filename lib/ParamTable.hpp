@@ -0,0 +1,150 @@
+//*************************************************************************************
+/** @file    ParamTable.hpp
+ *  @brief   Table of slave tuning parameters which the master downloads at startup
+ *  @details The slave keeps its tuning constants in RAM instead of in @c #defines.
+ * 			 It starts with its own defaults, and the master sends the values it
+ * 			 wants as one frame right after the comm handshake. Changing a tuning
+ * 			 value then only means reflashing the master.
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *	  \li 10-18-2026 ARB The tuning values are kept here, once for both bricks
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _PARAMTABLE_H_
+#define _PARAMTABLE_H_
+
+#ifdef HOST_BUILD
+#include <cstring>
+#else
+#include "../../yagarto-old/arm-none-eabi/include/c++/4.6.2/cstring"
+#endif
+
+#include "taskshare.hpp"
+
+/**************************************************************************************
+ * Parameter Table class
+ **************************************************************************************/
+/** @brief  Holds one value for each slave tuning parameter.
+ *  @details Both bricks must be built with the same @c paramID list, since the
+ * 			 table goes over the link as raw floats in that order. A table of the
+ * 			 wrong size is refused, so the slave keeps its defaults if the bricks
+ * 			 were built from different versions.
+ *
+ * 			 The table is only written by the slave comm task before @c CommReady
+ * 			 is set, and the tasks which read it don't start until then, so @c get()
+ * 			 needs no critical section.
+ */
+
+class ParamTable
+{
+
+public:
+
+	//Every parameter in the table. Add new ones at the end, before NUM_PARAMS.
+	enum paramID
+	{
+		parPreGrabHeight = 0,    /**<Lifter height before grabbing rings, in inches*/
+		parGrabHeight = 1,       /**<Lifter height to grab rings at, in inches*/
+		parPostGrabHeight = 2,   /**<Lifter height after grabbing rings, in inches*/
+		parPreReleaseHeight = 3, /**<Lifter height before placing rings, in inches*/
+		parReleaseHeight = 4,    /**<Lifter height to place rings at, in inches*/
+		parPostReleaseHeight = 5,/**<Lifter height after placing rings, in inches*/
+		parLiftScale = 6,        /**<Lifter encoder ticks per inch*/
+		parLiftZero = 7,         /**<Lifter encoder ticks at zero inches*/
+		parLiftKp = 8,           /**<Lifter proportional gain*/
+		parLiftKi = 9,           /**<Lifter integral gain, applied to the error sum / 1024*/
+
+		NUM_PARAMS               /**<Number of parameters, must stay last*/
+	};
+
+	//Size of the table on the wire
+	static const U8 TABLE_BYTES = NUM_PARAMS * sizeof(float);
+
+	/** @brief   Make a table holding the defaults
+	 *  @param   p_defaults One value for each @c paramID, in order
+	 */
+	ParamTable(const float* p_defaults)
+	{
+		memcpy(values, p_defaults, TABLE_BYTES);
+	}
+
+	/** @brief   Read one parameter
+	 *  @param   id Which parameter
+	 *  @return  Its current value
+	 */
+	float get(paramID id)
+	{
+		return values[id];
+	}
+
+	/** @brief   Replace the whole table with one received from the master
+	 *  @param   data Raw floats, in @c paramID order
+	 *  @param   len  Number of bytes, must be @c TABLE_BYTES
+	 *  @return  False if the length was wrong and the table was left alone
+	 */
+	bool Load(const U8* data, U8 len)
+	{
+		if (len != TABLE_BYTES)
+		{
+			return false;
+		}
+
+		memcpy(values, data, TABLE_BYTES);
+		return true;
+	}
+
+	/** @brief   The table as raw bytes, for sending or checksumming
+	 */
+	U8* data(void)
+	{
+		return (U8*) values;
+	}
+
+protected:
+
+	//One value per parameter, in paramID order
+	float values[NUM_PARAMS];
+
+};
+
+
+/**************************************************************************************
+ * Slave Tuning
+ **************************************************************************************/
+//Values the slave runs with, in ParamTable::paramID order. The master sends them
+//during the handshake and the slave starts out with them in case it doesn't, so
+//changing one only means reflashing the master.
+const float SlaveTuningValues[ParamTable::NUM_PARAMS] =
+{
+	2.5,     //parPreGrabHeight (in)
+	3.25,    //parGrabHeight (in)
+	3.75,    //parPostGrabHeight (in)
+	11.5,    //parPreReleaseHeight (in)
+	11.0,    //parReleaseHeight (in)
+	10.25,   //parPostReleaseHeight (in)
+	571.51,  //parLiftScale (ticks/in)
+	-1516,   //parLiftZero (ticks)
+	1,       //parLiftKp
+	0.001    //parLiftKi
+};
+
+#endif
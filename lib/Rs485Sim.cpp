@@ -0,0 +1,274 @@
+//*************************************************************************************
+/** @file    Rs485Sim.cpp
+ *  @brief   Cpp file for the simulated RS485 link
+ *  @details Each byte sent is written to the socketpair with the time it should
+ * 			 arrive. The receiving end holds bytes back until that time, which
+ * 			 gives the baud rate and latency of a real cable without making the
+ * 			 sender wait.
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *	  \li 10-18-2026 ARB Bytes the socket has no room for are counted as lost
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <stdlib.h>
+
+//Need header file for the class
+#include "Rs485Sim.hpp"
+
+
+/**************************************************************************************
+ * Link state
+ **************************************************************************************/
+//Bits on the wire for each byte: start, 8 data, stop
+#define BITS_PER_BYTE 10
+
+namespace
+{
+	//State kept for each end of the cable
+	struct EndState
+	{
+		int fd;                 /**<This end of the socketpair*/
+		uint64_t lineFree;      /**<Time the transmitter is done with the last byte, in us*/
+		unsigned int seed;      /**<Random number state for loss and corruption*/
+		U32 lost;               /**<Bytes this end sent that were lost*/
+		U32 corrupted;          /**<Bytes this end sent that were corrupted*/
+		U32 head;               /**<Next free slot in pending*/
+		U32 tail;               /**<Oldest byte in pending*/
+	};
+
+	ecrobot::Rs485::LinkConfig sConfig = {0, 0, 0, 0};
+	EndState sEnd[2] = {{-1, 0, 1, 0, 0, 0, 0}, {-1, 0, 2, 0, 0, 0, 0}};
+
+	//Which end the calling thread is plugged into
+	__thread int tEnd = ecrobot::Rs485::END_MASTER;
+}
+
+
+namespace ecrobot
+{
+
+Rs485::WireByte Rs485::Pending[2][Rs485::PENDING_SIZE];
+
+
+/**************************************************************************************
+ * Constructor
+ **************************************************************************************/
+/** @brief  Class constructor
+ *  @details Nothing to set up, the cable is shared by every object.
+ */
+
+Rs485::Rs485(void)
+{
+}
+
+
+/**************************************************************************************
+ * Configure
+ **************************************************************************************/
+/** @brief   Set how the cable behaves
+ *  @param   config Baud rate, latency, loss and corruption for both directions
+ */
+
+void Rs485::Configure(const LinkConfig& config)
+{
+	sConfig = config;
+}
+
+
+/**************************************************************************************
+ * Create Link
+ **************************************************************************************/
+/** @brief   Make a new cable
+ *  @details Uses a sequenced packet socketpair so each byte and its arrival time
+ * 			 stay together. Both ends are non-blocking.
+ *  @return  False if the socketpair could not be made
+ */
+
+bool Rs485::CreateLink(void)
+{
+	int fds[2];
+
+	if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) != 0)
+	{
+		return false;
+	}
+
+	for (U8 n = 0; n < 2; n++)
+	{
+		fcntl(fds[n], F_SETFL, fcntl(fds[n], F_GETFL) | O_NONBLOCK);
+		sEnd[n].fd = fds[n];
+		sEnd[n].lineFree = 0;
+		sEnd[n].lost = 0;
+		sEnd[n].corrupted = 0;
+		sEnd[n].head = 0;
+		sEnd[n].tail = 0;
+	}
+
+	return true;
+}
+
+
+/**************************************************************************************
+ * Attach
+ **************************************************************************************/
+/** @brief   Plug the calling thread into one end of the cable
+ *  @param   end Which brick the thread is playing
+ */
+
+void Rs485::Attach(linkEnd end)
+{
+	tEnd = end;
+}
+
+
+/**************************************************************************************
+ * Send
+ **************************************************************************************/
+/** @brief   Send bytes to the other end
+ *  @details Each byte is given the time it finishes going out on the line, plus
+ * 			 the latency, then may be lost or have a bit flipped. If the other
+ * 			 end has stopped reading and the socket is full, the byte is lost
+ * 			 too, like a UART overrun, and counted with the others.
+ *  @param   data   Buffer holding the bytes
+ *  @param   offset Index of the first byte to send
+ *  @param   length Number of bytes to send
+ *  @return  Number of bytes sent, lost bytes included like on a real cable
+ */
+
+U32 Rs485::send(U8* data, U32 offset, U32 length)
+{
+	EndState& me = sEnd[tEnd];
+	uint64_t byteTime = (sConfig.baud > 0) ? (BITS_PER_BYTE * 1000000ULL / sConfig.baud) : 0;
+	uint64_t now = Now();
+	WireByte wb;
+
+	for (U32 i = 0; i < length; i++)
+	{
+		//The transmitter sends one byte after another
+		if (me.lineFree < now) {me.lineFree = now;}
+		me.lineFree += byteTime;
+
+		if (Random1000() < sConfig.lossPPT)
+		{
+			me.lost++;
+			continue;
+		}
+
+		wb.due = me.lineFree + sConfig.latency * 1000ULL;
+		wb.byte = data[offset + i];
+
+		if (Random1000() < sConfig.corruptPPT)
+		{
+			wb.byte ^= (U8) (1 << (rand_r(&me.seed) % 8));
+			me.corrupted++;
+		}
+
+		if (::send(me.fd, &wb, sizeof(wb), MSG_NOSIGNAL) != (ssize_t) sizeof(wb))
+		{
+			me.lost++;
+		}
+	}
+
+	return length;
+}
+
+
+/**************************************************************************************
+ * Receive
+ **************************************************************************************/
+/** @brief   Receive bytes which have arrived from the other end
+ *  @details Never waits. Bytes that are still on their way are left for a
+ * 			 later call.
+ *  @param   data   Buffer to put the bytes in
+ *  @param   offset Index in the buffer of the first byte
+ *  @param   length Most bytes to receive
+ *  @return  Number of bytes received
+ */
+
+U32 Rs485::receive(U8* data, U32 offset, U32 length)
+{
+	EndState& me = sEnd[tEnd];
+	WireByte* pending = Pending[tEnd];
+	uint64_t now = Now();
+	U32 n = 0;
+
+	//Take everything off the socket, as long as there is room to hold it
+	while (me.head - me.tail < PENDING_SIZE &&
+		   recv(me.fd, &pending[me.head % PENDING_SIZE], sizeof(WireByte), 0) == (ssize_t) sizeof(WireByte))
+	{
+		me.head++;
+	}
+
+	//Hand over the bytes which are due, in order
+	while (n < length && me.tail != me.head && pending[me.tail % PENDING_SIZE].due <= now)
+	{
+		data[offset + n++] = pending[me.tail % PENDING_SIZE].byte;
+		me.tail++;
+	}
+
+	return n;
+}
+
+
+/**************************************************************************************
+ * Counters
+ **************************************************************************************/
+/** @brief   Bytes sent by the calling thread's end which the cable lost
+ */
+
+U32 Rs485::getBytesLost(void)
+{
+	return sEnd[tEnd].lost;
+}
+
+/** @brief   Bytes sent by the calling thread's end which the cable corrupted
+ */
+
+U32 Rs485::getBytesCorrupted(void)
+{
+	return sEnd[tEnd].corrupted;
+}
+
+
+/**************************************************************************************
+ * Helpers
+ **************************************************************************************/
+/** @brief   Time in us on the same clock as @c NNxt::getTick()
+ */
+
+uint64_t Rs485::Now(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000ULL + now.tv_nsec / 1000;
+}
+
+/** @brief   Random number from 0 to 999 for the calling thread's end
+ */
+
+U16 Rs485::Random1000(void)
+{
+	return (U16) (rand_r(&sEnd[tEnd].seed) % 1000);
+}
+
+}
@@ -0,0 +1,138 @@
+//*************************************************************************************
+/** @file    Rs485Sim.hpp
+ *  @brief   A simulated RS485 link for running the comm code on a PC
+ *  @details When @c HOST_BUILD is defined, @c MessageClass uses this in place of
+ * 			 the ecrobot @c Rs485 class. The two ends of the cable are the two ends
+ * 			 of a Linux socketpair, so the Master and Slave comm engines can be run
+ * 			 as two threads of one program, or as two processes after a @c fork().
+ *
+ * 			 The link can be made to behave like a real (or a bad) cable:
+ * 			 \li Baud rate: bytes take 10 bit times each to go out, one after another
+ * 			 \li Latency: extra delay before a byte can be received
+ * 			 \li Loss: bytes that never arrive
+ * 			 \li Corruption: bytes that arrive with one bit flipped
+ *
+ * 			 Typical use:
+ * 			 @code
+ * 			 ecrobot::Rs485::LinkConfig cfg = {115200, 2, 10, 5};
+ * 			 ecrobot::Rs485::Configure(cfg);
+ * 			 ecrobot::Rs485::CreateLink();
+ * 			 //then, in the thread (or process) that plays each brick:
+ * 			 ecrobot::Rs485::Attach(ecrobot::Rs485::END_MASTER);
+ * 			 @endcode
+ * 			 Build with @c -DHOST_BUILD and link with @c -lpthread.
+ *
+ *  Revised:
+ *	  \li 10-18-2026 ARB Original file
+ *
+ *  License:
+ *
+ *   Copyright (C) 2015 Alex Baucom
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _RS485SIM_H_
+#define _RS485SIM_H_
+
+#include "HostOS.hpp"
+
+namespace ecrobot
+{
+
+/**************************************************************************************
+ * Simulated Rs485 class
+ **************************************************************************************/
+/** @brief  Drop-in replacement for @c ecrobot::Rs485 on a PC.
+ *  @details @c send() and @c receive() behave like the real ones: sending never
+ * 			 waits for the other end, and receiving returns whatever has arrived
+ * 			 so far without blocking. Which end of the cable an object talks
+ * 			 through is chosen per thread with @c Attach(), so the single global
+ * 			 @c MsgComm object in MessageClass.cpp works for both bricks.
+ */
+
+class Rs485
+{
+
+public:
+
+	//The two ends of the cable
+	enum linkEnd
+	{
+		END_MASTER = 0,
+		END_SLAVE  = 1
+	};
+
+	//How the cable behaves, the same in both directions
+	struct LinkConfig
+	{
+		U32 baud;       /**<Bits per second, 0 for no transmission time*/
+		U32 latency;    /**<Extra delay on every byte, in ms*/
+		U16 lossPPT;    /**<Bytes lost per thousand sent*/
+		U16 corruptPPT; /**<Bytes with a flipped bit per thousand sent*/
+	};
+
+	//Constructor
+	Rs485(void);
+
+	//Set how the cable behaves. Call before any threads use the link.
+	static void Configure(const LinkConfig& config);
+
+	//Make a new cable. Call once, before Attach() or fork().
+	static bool CreateLink(void);
+
+	//Plug the calling thread into one end of the cable
+	static void Attach(linkEnd end);
+
+	//Send bytes to the other end
+	U32 send(U8* data, U32 offset, U32 length);
+
+	//Receive bytes which have arrived from the other end
+	U32 receive(U8* data, U32 offset, U32 length);
+
+	//Counters for what the simulated cable did to the bytes sent from this thread
+	static U32 getBytesLost(void);
+	static U32 getBytesCorrupted(void);
+
+protected:
+
+	//One byte on the wire and the time it can be received
+	struct WireByte
+	{
+		uint64_t due;   /**<Time the byte is received, in us*/
+		U8 byte;
+	};
+
+	//Largest number of bytes that can be in flight to one end
+	static const U32 PENDING_SIZE = 4096;
+
+	//Bytes which have arrived at each end but may not be due yet
+	static WireByte Pending[2][PENDING_SIZE];
+
+	//Time in us on the same clock as NNxt::getTick()
+	static uint64_t Now(void);
+
+	//Random number from 0 to 999
+	static U16 Random1000(void);
+
+};
+
+}
+
+
+//Fixes weird linker issues....
+#include "Rs485Sim.cpp"
+
+#endif
@@ -0,0 +1,223 @@
+//*************************************************************************************
+/** @file    taskqueue.hpp
+ *  @brief   Type-safe queue which can be shared between tasks in a thread-safe manner.
+ *  @details This file contains a template class for a first-in, first-out buffer of
+ *           data which is passed from one task to another. Like the shares in
+ *           @c taskshare.hpp, transfers take place inside critical sections which are
+ *           protected from being interrupted.
+ *
+ *  Revised:
+ *    \li 10-29-2012 JRR Original file
+ *    \li 10-18-2026 ARB Rewritten for nxtOSEK with a fixed size buffer that does not
+ *                       use the heap
+ *    \li 10-18-2026 ARB Added peek()
+ *
+ *  License:
+ *		This file was copyrighted 2014 by JR Ridgely and released under the Lesser GNU
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto.
+ *
+ * 		It has since been modified by Alex Baucom.
+ *
+ *		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _TASKQUEUE_H_
+#define _TASKQUEUE_H_
+
+#ifdef HOST_BUILD
+#include "HostOS.hpp"
+#else
+extern "C" {
+#include "../../nxtOSEK/toppers_osek/include/kernel.h"
+#include "kernel_id.h"
+#include "../../nxtOSEK/ecrobot/c/ecrobot_interface.h"
+}
+#endif
+
+//-------------------------------------------------------------------------------------
+/** @brief   Class for a queue of data passed in a thread-safe manner between tasks.
+ *  @details Unlike a @c TaskShare, which only keeps the most recent value, a queue
+ *           holds every item put into it until it is read out, in the order the items
+ *           were written. This keeps one task from overwriting a value before another
+ *           task has had a chance to read it.
+ *
+ *           The buffer is a fixed size array which is part of the object, so no
+ *           memory is allocated at run time. When the queue is full, @c put() refuses
+ *           the new item and returns @c false rather than overwriting old data; the
+ *           writer can decide whether to retry or drop it.
+ *
+ */
+
+template <class DataType, U8 QUEUE_SIZE = 8> class TaskQueue
+{
+	protected:
+		DataType buffer[QUEUE_SIZE];		///< Holds the items in the queue
+		U8 head;							///< Index where the next item is written
+		U8 tail;							///< Index where the next item is read
+		U8 count;							///< Number of items currently in the queue
+
+	public:
+		/** @brief   Construct an empty queue.
+		 */
+		TaskQueue<DataType, QUEUE_SIZE> (void)
+		{
+			head = 0;
+			tail = 0;
+			count = 0;
+		}
+
+		// This method is used to add an item to the back of the queue
+		bool put (DataType);
+
+		// This method is used to add an item from within an ISR only
+		bool ISR_put (DataType);
+
+		// This method is used to remove an item from the front of the queue
+		bool get (DataType&);
+
+		// This method is used to remove an item from within an ISR only
+		bool ISR_get (DataType&);
+
+		// This method is used to look at the front item without removing it
+		bool peek (DataType&);
+
+		/** @brief   Check if there is anything in the queue.
+		 *  @return  True if there are no items waiting to be read
+		 */
+		bool is_empty (void)
+		{
+			return (num_items_in () == 0);
+		}
+
+		/** @brief   Find out how many items are waiting to be read.
+		 *  @return  The number of items in the queue
+		 */
+		U8 num_items_in (void)
+		{
+			// A single byte is read atomically, so no critical section is needed
+			return (count);
+		}
+}; // class TaskQueue<DataType, QUEUE_SIZE>
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Put an item into the back of the queue.
+ *  @details The item is copied into the queue inside a critical section so that a
+ *           reader can't see a half-written item.
+ *  @param   new_data The data which is to be written
+ *  @return  True if the item was added, false if the queue was full
+ */
+
+template <class DataType, U8 QUEUE_SIZE>
+inline bool TaskQueue<DataType, QUEUE_SIZE>::put (DataType new_data)
+{
+	bool added;
+
+	SuspendAllInterrupts();
+	added = ISR_put (new_data);
+	ResumeAllInterrupts();
+
+	return (added);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Put an item into the back of the queue from within an ISR.
+ *  @details This method must only be called from within a hardware interrupt, for
+ *           the same reasons given for @c TaskShare::ISR_put().
+ *  @param   new_data The data which is to be written
+ *  @return  True if the item was added, false if the queue was full
+ */
+
+template <class DataType, U8 QUEUE_SIZE>
+bool TaskQueue<DataType, QUEUE_SIZE>::ISR_put (DataType new_data)
+{
+	if (count >= QUEUE_SIZE)
+	{
+		return (false);
+	}
+
+	buffer[head] = new_data;
+	if (++head >= QUEUE_SIZE) {head = 0;}
+	count++;
+
+	return (true);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Take the item at the front of the queue.
+ *  @param   data Reference to where the item is copied
+ *  @return  True if an item was read, false if the queue was empty
+ */
+
+template <class DataType, U8 QUEUE_SIZE>
+inline bool TaskQueue<DataType, QUEUE_SIZE>::get (DataType& data)
+{
+	bool got;
+
+	SuspendAllInterrupts();
+	got = ISR_get (data);
+	ResumeAllInterrupts();
+
+	return (got);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Take the item at the front of the queue from within an ISR.
+ *  @param   data Reference to where the item is copied
+ *  @return  True if an item was read, false if the queue was empty
+ */
+
+template <class DataType, U8 QUEUE_SIZE>
+bool TaskQueue<DataType, QUEUE_SIZE>::ISR_get (DataType& data)
+{
+	if (count == 0)
+	{
+		return (false);
+	}
+
+	data = buffer[tail];
+	if (++tail >= QUEUE_SIZE) {tail = 0;}
+	count--;
+
+	return (true);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Look at the item at the front of the queue, leaving it there.
+ *  @param   data Reference to where the item is copied
+ *  @return  True if there was an item, false if the queue was empty
+ */
+
+template <class DataType, U8 QUEUE_SIZE>
+bool TaskQueue<DataType, QUEUE_SIZE>::peek (DataType& data)
+{
+	bool got = false;
+
+	SuspendAllInterrupts();
+	if (count > 0)
+	{
+		data = buffer[tail];
+		got = true;
+	}
+	ResumeAllInterrupts();
+
+	return (got);
+}
+
+
+#endif  // _TASKQUEUE_H_
@@ -36,11 +36,15 @@
 #ifndef _TASKSHARE_H_
 #define _TASKSHARE_H_
 
+#ifdef HOST_BUILD
+#include "HostOS.hpp"
+#else
 extern "C" {
 #include "../../nxtOSEK/toppers_osek/include/kernel.h"
 #include "kernel_id.h"
 #include "../../nxtOSEK/ecrobot/c/ecrobot_interface.h"
 }
+#endif
 
 //-------------------------------------------------------------------------------------
 /** @brief   Class for data to be shared in a thread-safe manner between tasks.